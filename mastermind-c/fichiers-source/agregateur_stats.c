@@ -0,0 +1,152 @@
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include "agregateur_stats.h"
+#include "statistiques.h"
+
+// Fragment attribué au thread courant (tourniquet au premier appel)
+static _Thread_local int fragment_courant = -1;
+static atomic_uint prochain_fragment;
+
+static FragmentStats *fragment_du_thread(AgregateurStats *ag) {
+    if (fragment_courant < 0) {
+        unsigned n = atomic_fetch_add_explicit(&prochain_fragment, 1,
+                                               memory_order_relaxed);
+        fragment_courant = (int)(n % STATS_NB_FRAGMENTS);
+    }
+    return &ag->fragments[fragment_courant];
+}
+
+// Boucle du thread de sauvegarde : écrit un instantané à chaque intervalle
+// si au moins une partie a été enregistrée depuis la dernière écriture.
+static void *boucle_sauvegarde(void *arg) {
+    AgregateurStats *ag = arg;
+    pthread_mutex_lock(&ag->mutex);
+    while (!ag->arret) {
+        struct timespec ech;
+        clock_gettime(CLOCK_REALTIME, &ech);
+        ech.tv_sec  += ag->intervalle_ms / 1000;
+        ech.tv_nsec += (long)(ag->intervalle_ms % 1000) * 1000000L;
+        if (ech.tv_nsec >= 1000000000L) { ech.tv_sec++; ech.tv_nsec -= 1000000000L; }
+
+        int rc = 0;
+        while (!ag->arret && rc != ETIMEDOUT)
+            rc = pthread_cond_timedwait(&ag->cond, &ag->mutex, &ech);
+        if (ag->arret) break;
+
+        pthread_mutex_unlock(&ag->mutex);
+        agregateur_persister(ag);
+        pthread_mutex_lock(&ag->mutex);
+    }
+    pthread_mutex_unlock(&ag->mutex);
+    return NULL;
+}
+
+bool agregateur_init(AgregateurStats *ag, const char *chemin,
+                     int intervalle_ms, bool partage) {
+    memset(ag, 0, sizeof(*ag));
+    ag->chemin = chemin;
+    ag->intervalle_ms = intervalle_ms;
+    // Si le segment partagé est indisponible, on retombe sur le fichier seul
+    ag->partage = partage && stats_partagees_ouvrir(&ag->segment, chemin);
+    if (!ag->partage) charger_stats(&ag->base, chemin);
+    for (int i=0;i<STATS_NB_FRAGMENTS;i++) {
+        atomic_init(&ag->fragments[i].games_played, 0);
+        atomic_init(&ag->fragments[i].games_won, 0);
+        atomic_init(&ag->fragments[i].total_tries, 0);
+        atomic_init(&ag->fragments[i].total_time_ns, 0);
+    }
+    atomic_init(&ag->version, 0);
+    pthread_mutex_init(&ag->mutex, NULL);
+    pthread_cond_init(&ag->cond, NULL);
+
+    if (intervalle_ms > 0) {
+        if (pthread_create(&ag->thread, NULL, boucle_sauvegarde, ag) != 0)
+            return false;
+        ag->thread_actif = true;
+    }
+    return true;
+}
+
+void agregateur_enregistrer(AgregateurStats *ag, bool gagne,
+                            int tentatives, double duree_sec) {
+    FragmentStats *f = fragment_du_thread(ag);
+    atomic_fetch_add_explicit(&f->games_played, 1, memory_order_relaxed);
+    if (gagne)
+        atomic_fetch_add_explicit(&f->games_won, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&f->total_tries, (unsigned long)tentatives,
+                              memory_order_relaxed);
+    if (duree_sec > 0.0)
+        atomic_fetch_add_explicit(&f->total_time_ns,
+                                  (unsigned long long)(duree_sec * 1e9),
+                                  memory_order_relaxed);
+    atomic_fetch_add_explicit(&ag->version, 1, memory_order_release);
+}
+
+// Somme de la base et de tous les fragments (lecture sans verrou)
+static void fusionner_fragments(AgregateurStats *ag, Stats *out) {
+    *out = ag->base;
+    unsigned long long ns = 0;
+    for (int i=0;i<STATS_NB_FRAGMENTS;i++) {
+        FragmentStats *f = &ag->fragments[i];
+        out->games_played += atomic_load_explicit(&f->games_played, memory_order_relaxed);
+        out->games_won    += atomic_load_explicit(&f->games_won, memory_order_relaxed);
+        out->total_tries  += atomic_load_explicit(&f->total_tries, memory_order_relaxed);
+        ns += atomic_load_explicit(&f->total_time_ns, memory_order_relaxed);
+    }
+    out->total_time += (double)ns / 1e9;
+}
+
+// Publie dans le segment partagé ce qui a été enregistré depuis la
+// dernière publication (appelé par le thread de sauvegarde et la lecture).
+static void publier_deltas(AgregateurStats *ag) {
+    pthread_mutex_lock(&ag->mutex);
+    Stats courant, delta;
+    fusionner_fragments(ag, &courant);
+    delta.games_played = courant.games_played - ag->publie.games_played;
+    delta.games_won    = courant.games_won - ag->publie.games_won;
+    delta.total_tries  = courant.total_tries - ag->publie.total_tries;
+    delta.total_time   = courant.total_time - ag->publie.total_time;
+    stats_partagees_ajouter(&ag->segment, &delta);
+    ag->publie = courant;
+    pthread_mutex_unlock(&ag->mutex);
+}
+
+void agregateur_lire(AgregateurStats *ag, Stats *out) {
+    if (ag->partage) {
+        publier_deltas(ag);
+        stats_partagees_lire(&ag->segment, out);
+        return;
+    }
+    fusionner_fragments(ag, out);
+}
+
+bool agregateur_persister(AgregateurStats *ag) {
+    if (ag->partage) {
+        // Le fichier n'est écrit qu'à la fermeture ; ici on publie seulement
+        publier_deltas(ag);
+        return true;
+    }
+    unsigned long v = atomic_load_explicit(&ag->version, memory_order_acquire);
+    if (v == ag->version_sauvee) return true;
+    Stats instantane;
+    agregateur_lire(ag, &instantane);
+    if (!sauvegarder_stats(&instantane, ag->chemin)) return false;
+    ag->version_sauvee = v;
+    return true;
+}
+
+void agregateur_fermer(AgregateurStats *ag) {
+    if (ag->thread_actif) {
+        pthread_mutex_lock(&ag->mutex);
+        ag->arret = true;
+        pthread_cond_signal(&ag->cond);
+        pthread_mutex_unlock(&ag->mutex);
+        pthread_join(ag->thread, NULL);
+        ag->thread_actif = false;
+    }
+    agregateur_persister(ag);
+    if (ag->partage) stats_partagees_fermer(&ag->segment);
+    pthread_cond_destroy(&ag->cond);
+    pthread_mutex_destroy(&ag->mutex);
+}
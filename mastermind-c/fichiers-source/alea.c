@@ -0,0 +1,82 @@
+#include <stdatomic.h>
+#include <sys/random.h>
+#include <time.h>
+#include <unistd.h>
+#include "alea.h"
+#include "couleurs.h"
+
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// L'état est dérivé de la graine par splitmix64 (jamais entièrement nul)
+void alea_init(Alea *a, uint64_t graine) {
+    for (int i=0;i<4;i++) a->s[i] = splitmix64(&graine);
+}
+
+uint64_t alea_suivant(Alea *a) {
+    uint64_t *s = a->s;
+    uint64_t r = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return r;
+}
+
+// Méthode de Lemire : multiplication 32x32 -> 64 bits, rejet seulement
+// dans la petite zone qui introduirait un biais (contrairement à % n).
+uint32_t alea_borne(Alea *a, uint32_t n) {
+    uint32_t x = (uint32_t)(alea_suivant(a) >> 32);
+    uint64_t m = (uint64_t)x * n;
+    uint32_t bas = (uint32_t)m;
+    if (bas < n) {
+        uint32_t seuil = -n % n;
+        while (bas < seuil) {
+            x = (uint32_t)(alea_suivant(a) >> 32);
+            m = (uint64_t)x * n;
+            bas = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+// Graine du noyau ; à défaut horloge + pid + compteur, pour que deux
+// parties lancées dans la même seconde n'aient pas le même secret.
+uint64_t alea_graine_systeme(void) {
+    static atomic_ulong compteur;
+    uint64_t g;
+    if (getrandom(&g, sizeof(g), GRND_NONBLOCK) == (ssize_t)sizeof(g)) return g;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    g = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    g ^= (uint64_t)getpid() << 32;
+    g ^= atomic_fetch_add(&compteur, 1) * 0x9e3779b97f4a7c15ULL;
+    return splitmix64(&g);
+}
+
+void generer_secret(char secret[CODE_LEN], int color_count,
+                    bool allow_repetition, Alea *a) {
+    if (allow_repetition) {
+        for (int i=0;i<CODE_LEN;i++)
+            secret[i] = GLOBAL_COLOR_SET[alea_borne(a, (uint32_t)color_count)];
+    } else {
+        char pool[MAX_COLORS];
+        for (int i=0;i<color_count;i++) pool[i]=GLOBAL_COLOR_SET[i];
+        for (int i=color_count-1;i>0;i--) {
+            int j=(int)alea_borne(a, (uint32_t)(i+1));
+            char t=pool[i]; pool[i]=pool[j]; pool[j]=t;
+        }
+        for (int k=0;k<CODE_LEN;k++) secret[k]=pool[k];
+    }
+}
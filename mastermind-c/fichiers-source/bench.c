@@ -0,0 +1,597 @@
+/*
+ * Mesures de performance.
+ *
+ * Usage : bench [noyaux [options] | tuiles | reprise [fichiers] | minuteurs [nb]]
+ *
+ *   noyaux                  feedback, parseur, génération des codes, filtrage,
+ *                           choix de l'IA, sauvegarde/chargement
+ *     --repetitions N       nombre de mesures par noyau (101 par défaut)
+ *     --enregistrer FICHIER écrit les résultats comme référence
+ *     --comparer FICHIER    compare à une référence ; code de sortie 2 si un
+ *                           noyau est plus de SEUIL_REGRESSION fois plus lent
+ *   tuiles                  histogrammes de partition, version directe contre
+ *                           version par tuiles, selon la taille de l'espace
+ *   reprise                 l'IA reprend chaque sauvegarde (save.txt par
+ *                           défaut) : filtrage par l'historique, puis temps
+ *                           de choix jusqu'à la fin de la partie
+ *
+ * Chaque noyau est calibré (assez d'appels pour ~2 ms par mesure), chauffé,
+ * puis mesuré N fois ; on affiche la médiane et le p99 du temps par appel.
+ * Les noyaux lents (choix de l'IA) ont moins de mesures, pour tenir en
+ * quelques secondes chacun.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "alea.h"
+#include "horloge.h"
+#include "minuteurs.h"
+#include "feedback.h"
+#include "parse.h"
+#include "rang.h"
+#include "sauvegarde.h"
+#include "solveur_noyaux.h"
+
+#define MESURE_CIBLE_NS   2000000ULL   // durée visée pour une mesure
+#define ECHAUFFEMENT      3
+#define MAX_NOYAUX        32
+#define SEUIL_REGRESSION  1.10
+#define BUDGET_NOYAU_NS   3000000000ULL // plafond de temps de mesure par noyau
+#define MIN_REPETITIONS   11
+
+/* ============================================================
+   Noyaux mesurés : chacun exécute n fois l'opération
+   ============================================================ */
+
+static volatile unsigned puits;     // empêche l'élimination des calculs
+
+static char codes_rep[SOLVEUR_MAX_CODES][CODE_LEN];    // 6 couleurs, répétitions
+static char codes_sans[SOLVEUR_MAX_CODES][CODE_LEN];   // 6 couleurs, sans
+static SignatureCode sig_rep[SOLVEUR_MAX_CODES], sig_sans[SOLVEUR_MAX_CODES];
+static int nb_rep, nb_sans;
+static bool actif[SOLVEUR_MAX_CODES];
+static GameState partie;
+static char chemin_sauvegarde[64];
+
+static const GameConfig cfg_rep  = { 6, 10, true,  false, 0 };
+static const GameConfig cfg_sans = { 6, 10, false, false, 0 };
+
+static void noyau_feedback(size_t n) {
+    unsigned acc = 0;
+    int i = 0, j = 517;
+    for (size_t k = 0; k < n; k++) {
+        int b, w;
+        calculer_feedback(codes_rep[i], codes_rep[j], &b, &w);
+        acc += (unsigned)(b * 5 + w);
+        if (++i == nb_rep) i = 0;
+        if ((j += 7) >= nb_rep) j -= nb_rep;
+    }
+    puits += acc;
+}
+
+// Même parcours, signatures précalculées (chemin du solveur)
+static void noyau_feedback_signatures(size_t n) {
+    unsigned acc = 0;
+    int i = 0, j = 517;
+    for (size_t k = 0; k < n; k++) {
+        acc += (unsigned)case_signatures(sig_rep[i], sig_rep[j]);
+        if (++i == nb_rep) i = 0;
+        if ((j += 7) >= nb_rep) j -= nb_rep;
+    }
+    puits += acc;
+}
+
+static void noyau_parseur(size_t n) {
+    static const char *lignes[] = {
+        "RGBY", "r g b y", "R-G-B-O", "pygb", "RGBX", "R G B", "ooPP", " y , o , g , r "
+    };
+    const size_t nb = sizeof(lignes) / sizeof(lignes[0]);
+    unsigned acc = 0;
+    for (size_t k = 0; k < n; k++) {
+        char code[CODE_LEN];
+        acc += parser_proposition(lignes[k % nb], code, 6, true);
+    }
+    puits += acc;
+}
+
+// Tampon de 1024 propositions, une par ligne, comme en mode lot
+static char lignes_lot[1024 * 8];
+static size_t taille_lot;
+
+static void noyau_parseur_lot(size_t n) {
+    static CodeCompact codes[1024];
+    unsigned acc = 0;
+    for (size_t k = 0; k < n; k += 1024) {
+        size_t lu;
+        acc += (unsigned)parser_propositions(lignes_lot, taille_lot, 6, true,
+                                             codes, 1024, &lu);
+        acc += codes[k & 1023];
+    }
+    puits += acc;
+}
+
+static void noyau_generation(size_t n) {
+    static char tampon[SOLVEUR_MAX_CODES][CODE_LEN];
+    for (size_t k = 0; k < n; k++)
+        puits += (unsigned)generate_all_codes(tampon, &cfg_rep);
+}
+
+// Aller-retour rang -> code -> rang sur l'espace sans répétition
+static void noyau_rang(size_t n) {
+    for (size_t k = 0; k < n; k++) {
+        CodeCompact v;
+        code_depuis_rang((int)(k % 360), 6, false, &v);
+        puits += (unsigned)code_rang(v, 6, false);
+    }
+}
+
+// Premier filtrage de la partie (1296 codes actifs) ; la remise à zéro
+// des drapeaux est comprise dans la mesure.
+static void noyau_filtrage(size_t n) {
+    CompteursSolveur cpt = {0};
+    const char *secret = codes_rep[811];
+    for (size_t k = 0; k < n; k++) {
+        const char *guess = codes_rep[(k * 37) % (size_t)nb_rep];
+        int b, w;
+        calculer_feedback(secret, guess, &b, &w);
+        memset(actif, true, sizeof(actif));
+        puits += (unsigned)filter_possibilities(sig_rep, actif, nb_rep,
+                                                guess, b, w, &cpt);
+    }
+}
+
+// Historique de 8 coups contre un secret fixe, appliqué à tout l'espace :
+// en une passe, puis filtrage après filtrage
+#define NB_HISTORIQUE 8
+static char hist_codes[NB_HISTORIQUE][CODE_LEN];
+static int hist_noirs[NB_HISTORIQUE], hist_blancs[NB_HISTORIQUE];
+static SignatureCode hist_sig[NB_HISTORIQUE];
+static uint8_t hist_cases[NB_HISTORIQUE];
+
+static void noyau_historique(size_t n) {
+    CompteursSolveur cpt = {0};
+    for (size_t k = 0; k < n; k++) {
+        memset(actif, true, sizeof(actif));
+        puits += (unsigned)filtrer_contraintes(sig_rep, actif, nb_rep, hist_sig,
+                                               hist_cases, NB_HISTORIQUE, &cpt);
+    }
+}
+
+static void noyau_historique_seq(size_t n) {
+    CompteursSolveur cpt = {0};
+    for (size_t k = 0; k < n; k++) {
+        memset(actif, true, sizeof(actif));
+        for (int j = 0; j < NB_HISTORIQUE; j++)
+            puits += (unsigned)filter_possibilities(sig_rep, actif, nb_rep, hist_codes[j],
+                                                    hist_noirs[j], hist_blancs[j], &cpt);
+    }
+}
+
+static void choix_premier_coup(size_t n, char codes[][CODE_LEN],
+                               const SignatureCode sig[], int nb) {
+    CompteursSolveur cpt = {0};
+    for (size_t k = 0; k < n; k++) {
+        char guess[CODE_LEN];
+        memset(actif, true, sizeof(actif));
+        choose_next_guess(guess, codes, sig, actif, nb, NULL, NULL, NULL, &cpt);
+        puits += (unsigned)guess[0];
+    }
+}
+
+static void noyau_choix_360(size_t n)  { choix_premier_coup(n, codes_sans, sig_sans, nb_sans); }
+static void noyau_choix_1296(size_t n) { choix_premier_coup(n, codes_rep, sig_rep, nb_rep); }
+
+// Partie complète de l'IA (360 codes), secret différent à chaque appel ;
+// « cache » : cache de feedbacks partagé par les parties, ou NULL
+static void partie_ia(size_t n, ModeSolveur mode, CacheFeedback *cache) {
+    static size_t secret = 0;
+    for (size_t k = 0; k < n; k++) {
+        Solveur *sv = solveur_creer(&cfg_sans);
+        solveur_choisir_mode(sv, mode);
+        solveur_utiliser_cache(sv, cache);
+        const char *s = codes_sans[secret++ % (size_t)nb_sans];
+        for (int t = 0; t < 30; t++) {
+            char g[CODE_LEN];
+            int b, w;
+            solveur_proposer(sv, g);
+            calculer_feedback(s, g, &b, &w);
+            if (b == CODE_LEN) break;
+            solveur_filtrer(sv, g, b, w);
+        }
+        puits += (unsigned)solveur_restants(sv);
+        solveur_detruire(sv);
+    }
+}
+
+static CacheFeedback *cache_sans;
+
+static void noyau_partie_recalcul(size_t n)    { partie_ia(n, SOLVEUR_RECALCUL, NULL); }
+static void noyau_partie_incremental(size_t n) { partie_ia(n, SOLVEUR_INCREMENTAL, NULL); }
+static void noyau_partie_rec_cache(size_t n)   { partie_ia(n, SOLVEUR_RECALCUL, cache_sans); }
+static void noyau_partie_inc_cache(size_t n)   { partie_ia(n, SOLVEUR_INCREMENTAL, cache_sans); }
+
+static void noyau_sauvegarde(size_t n) {
+    char buf[4096];
+    GameState relu;
+    for (size_t k = 0; k < n; k++) {
+        formater_partie(&partie, buf, sizeof(buf));
+        puits += analyser_partie(&relu, buf);
+    }
+}
+
+static void noyau_sauvegarde_fichier(size_t n) {
+    GameState relu;
+    for (size_t k = 0; k < n; k++) {
+        sauvegarder_partie(&partie, chemin_sauvegarde);
+        puits += charger_partie(&relu, chemin_sauvegarde);
+    }
+}
+
+static void preparer_noyaux(void) {
+    nb_rep = generate_all_codes(codes_rep, &cfg_rep);
+    nb_sans = generate_all_codes(codes_sans, &cfg_sans);
+    signer_codes(codes_rep, nb_rep, sig_rep);
+    signer_codes(codes_sans, nb_sans, sig_sans);
+    for (int j = 0; j < NB_HISTORIQUE; j++) {
+        memcpy(hist_codes[j], codes_rep[(j * 331 + 17) % nb_rep], CODE_LEN);
+        calculer_feedback(codes_rep[811], hist_codes[j], &hist_noirs[j], &hist_blancs[j]);
+        hist_sig[j] = sig_rep[(j * 331 + 17) % nb_rep];
+        hist_cases[j] = (uint8_t)(hist_noirs[j] * 5 + hist_blancs[j]);
+    }
+    cache_sans = cache_feedback_creer(nb_sans, 1 << 20);
+    for (int i = 0; i < 1024; i++) {
+        const char *c = codes_rep[(i * 97) % nb_rep];
+        taille_lot += (size_t)snprintf(lignes_lot + taille_lot, 8, "%.4s%s\n",
+                                       c, i % 3 ? "" : "\r");
+    }
+
+    // Partie de 10 coups, typique d'une sauvegarde en cours de jeu
+    Alea a;
+    alea_init(&a, 7);
+    memset(&partie, 0, sizeof(partie));
+    partie.cfg = cfg_rep;
+    partie.cfg.max_tries = 12;
+    partie.in_progress = true;
+    memcpy(partie.secret, codes_rep[alea_borne(&a, (uint32_t)nb_rep)], CODE_LEN);
+    for (int i = 0; i < 10; i++) {
+        memcpy(partie.guesses[i], codes_rep[alea_borne(&a, (uint32_t)nb_rep)], CODE_LEN);
+        calculer_feedback(partie.secret, partie.guesses[i],
+                          &partie.blacks[i], &partie.whites[i]);
+        partie.durees_ns[i] = 1000000000ULL + alea_borne(&a, 1000000000u);
+        partie.duree_ns += partie.durees_ns[i];
+    }
+    partie.tries = 10;
+    snprintf(chemin_sauvegarde, sizeof(chemin_sauvegarde),
+             "/tmp/mastermind-bench-%ld.txt", (long)getpid());
+}
+
+typedef struct {
+    const char *nom;
+    void (*executer)(size_t n);
+} Noyau;
+
+static const Noyau NOYAUX[] = {
+    { "feedback",           noyau_feedback },
+    { "feedback_signatures", noyau_feedback_signatures },
+    { "parseur",            noyau_parseur },
+    { "parseur_lot",        noyau_parseur_lot },    // par proposition
+    { "generation_1296",    noyau_generation },
+    { "rang_360",           noyau_rang },
+    { "filtrage_1296",      noyau_filtrage },
+    { "historique_1296",    noyau_historique },     // 8 contraintes
+    { "historique_seq_1296", noyau_historique_seq },
+    { "choix_360",          noyau_choix_360 },
+    { "choix_1296",         noyau_choix_1296 },
+    { "partie_ia_recalcul", noyau_partie_recalcul },
+    { "partie_ia_increm",   noyau_partie_incremental },
+    { "partie_ia_rec_cache", noyau_partie_rec_cache },     // cache chaud
+    { "partie_ia_inc_cache", noyau_partie_inc_cache },
+    { "sauvegarde_memoire", noyau_sauvegarde },
+    { "sauvegarde_fichier", noyau_sauvegarde_fichier },
+};
+#define NB_NOYAUX (int)(sizeof(NOYAUX) / sizeof(NOYAUX[0]))
+
+/* ============================================================
+   Mesure : calibrage, échauffement, médiane et p99
+   ============================================================ */
+
+typedef struct {
+    char nom[32];
+    double mediane_ns;      // par appel
+    double p99_ns;
+    int mesures;
+} Mesure;
+
+static int comparer_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static Mesure mesurer(const Noyau *nk, int repetitions, double *echantillons) {
+    size_t n = 1;
+    uint64_t dt;
+    for (;;) {
+        uint64_t t0 = horloge_ns();
+        nk->executer(n);
+        dt = horloge_ns() - t0;
+        if (dt >= MESURE_CIBLE_NS || n >= (1u << 26)) break;
+        n *= 2;
+    }
+    if (dt * (uint64_t)(repetitions + ECHAUFFEMENT) > BUDGET_NOYAU_NS) {
+        int r = (int)(BUDGET_NOYAU_NS / dt) - ECHAUFFEMENT;
+        repetitions = r < MIN_REPETITIONS ? MIN_REPETITIONS : r;
+    }
+    for (int r = 0; r < ECHAUFFEMENT; r++)
+        nk->executer(n);
+
+    for (int r = 0; r < repetitions; r++) {
+        uint64_t t0 = horloge_ns();
+        nk->executer(n);
+        echantillons[r] = (double)(horloge_ns() - t0) / (double)n;
+    }
+    qsort(echantillons, (size_t)repetitions, sizeof(double), comparer_doubles);
+
+    // p99 au rang le plus proche : le maximum tant qu'il y a moins de 100 mesures
+    int rang = (repetitions * 99 + 99) / 100 - 1;
+    Mesure m;
+    snprintf(m.nom, sizeof(m.nom), "%s", nk->nom);
+    m.mediane_ns = echantillons[repetitions / 2];
+    m.p99_ns = echantillons[rang];
+    m.mesures = repetitions;
+    return m;
+}
+
+// Référence : une ligne « nom mediane_ns p99_ns » par noyau
+static int lire_reference(const char *chemin, Mesure ref[MAX_NOYAUX]) {
+    FILE *f = fopen(chemin, "r");
+    if (!f) return -1;
+    int nb = 0;
+    while (nb < MAX_NOYAUX &&
+           fscanf(f, "%31s %lf %lf", ref[nb].nom, &ref[nb].mediane_ns,
+                  &ref[nb].p99_ns) == 3)
+        nb++;
+    fclose(f);
+    return nb;
+}
+
+static bool ecrire_reference(const char *chemin, const Mesure *m, int nb) {
+    FILE *f = fopen(chemin, "w");
+    if (!f) return false;
+    for (int i = 0; i < nb; i++)
+        fprintf(f, "%s %.3f %.3f\n", m[i].nom, m[i].mediane_ns, m[i].p99_ns);
+    return fclose(f) == 0;
+}
+
+static int bench_noyaux(int argc, char **argv) {
+    int repetitions = 101;
+    const char *enregistrer = NULL, *comparer = NULL;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+            repetitions = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--enregistrer") == 0 && i + 1 < argc)
+            enregistrer = argv[++i];
+        else if (strcmp(argv[i], "--comparer") == 0 && i + 1 < argc)
+            comparer = argv[++i];
+        else {
+            fprintf(stderr, "Option inconnue : %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (repetitions < 1) repetitions = 1;
+
+    Mesure ref[MAX_NOYAUX];
+    int nb_ref = 0;
+    if (comparer && (nb_ref = lire_reference(comparer, ref)) < 0) {
+        fprintf(stderr, "Impossible de lire la référence %s\n", comparer);
+        return 1;
+    }
+
+    preparer_noyaux();
+    double *echantillons = malloc((size_t)repetitions * sizeof(double));
+    Mesure res[MAX_NOYAUX];
+    bool regression = false;
+
+    printf("%-20s %7s %14s %14s", "noyau", "mesures", "mediane (ns)", "p99 (ns)");
+    if (comparer) printf(" %14s %8s", "reference", "ecart");
+    printf("\n");
+
+    for (int i = 0; i < NB_NOYAUX; i++) {
+        res[i] = mesurer(&NOYAUX[i], repetitions, echantillons);
+        printf("%-20s %7d %14.1f %14.1f", res[i].nom, res[i].mesures,
+               res[i].mediane_ns, res[i].p99_ns);
+        for (int j = 0; comparer && j < nb_ref; j++) {
+            if (strcmp(ref[j].nom, res[i].nom) != 0) continue;
+            double ratio = res[i].mediane_ns / ref[j].mediane_ns;
+            printf(" %14.1f %+7.1f%%", ref[j].mediane_ns, (ratio - 1.0) * 100.0);
+            if (ratio > SEUIL_REGRESSION) {
+                printf("  plus lent");
+                regression = true;
+            }
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+
+    free(echantillons);
+    unlink(chemin_sauvegarde);
+    if (enregistrer && !ecrire_reference(enregistrer, res, NB_NOYAUX)) {
+        fprintf(stderr, "Impossible d'écrire %s\n", enregistrer);
+        return 1;
+    }
+    return regression ? 2 : 0;
+}
+
+/* ============================================================
+   Histogrammes : débit selon la taille de l'espace des codes
+   ============================================================ */
+
+typedef uint64_t (*NoyauHistogrammes)(const SignatureCode [], const bool [], int,
+                                      uint16_t [][25]);
+
+// Médiane du temps par feedback sur quelques constructions complètes
+static double mesurer_histogrammes(NoyauHistogrammes f, const SignatureCode sig[],
+                                   int nb, uint16_t hist[][25]) {
+    double ech[15];
+    for (int r = 0; r < 15; r++) {
+        uint64_t t0 = horloge_ns();
+        uint64_t fb = f(sig, actif, nb, hist);
+        ech[r] = (double)(horloge_ns() - t0) / (double)fb;
+    }
+    qsort(ech, 15, sizeof(double), comparer_doubles);
+    return ech[7];
+}
+
+static int bench_tuiles(void) {
+    static char codes[SOLVEUR_MAX_CODES][CODE_LEN];
+    static SignatureCode sig[SOLVEUR_MAX_CODES];
+    static uint16_t h1[SOLVEUR_MAX_CODES][25], h2[SOLVEUR_MAX_CODES][25];
+    static const GameConfig cfgs[] = {
+        { 3, 10, true, false, 0 }, { 4, 10, true, false, 0 },
+        { 6, 10, false, false, 0 }, { 5, 10, true, false, 0 },
+        { 6, 10, true, false, 0 },
+    };
+    int erreurs = 0;
+
+    printf("%6s %16s %16s %10s\n", "codes", "direct (ns/fb)", "tuiles (ns/fb)",
+           "tuiles Mfb/s");
+    for (size_t k = 0; k < sizeof(cfgs) / sizeof(cfgs[0]); k++) {
+        int nb = generate_all_codes(codes, &cfgs[k]);
+        signer_codes(codes, nb, sig);
+        // Un code sur trois éliminé, comme en cours de partie
+        for (int i = 0; i < nb; i++) actif[i] = i % 3 != 1;
+        double d = mesurer_histogrammes(histogrammes_direct, sig, nb, h1);
+        double t = mesurer_histogrammes(histogrammes_tuiles, sig, nb, h2);
+        for (int i = 0; i < nb; i++)
+            if (actif[i] && memcmp(h1[i], h2[i], sizeof(h1[i])) != 0) erreurs++;
+        printf("%6d %16.2f %16.2f %10.1f\n", nb, d, t, 1e3 / t);
+    }
+    if (erreurs) printf("ERREUR: %d histogrammes differents\n", erreurs);
+    return erreurs ? 1 : 0;
+}
+
+/* ============================================================
+   Reprise par l'IA depuis des sauvegardes
+   ============================================================ */
+
+static int bench_reprise(int argc, char **argv) {
+    static char *defaut[] = { "save.txt" };
+    if (argc == 0) {
+        argc = 1;
+        argv = defaut;
+    }
+    int erreurs = 0;
+    printf("%-24s %6s %10s %14s %14s %6s\n", "sauvegarde", "coups", "restants",
+           "historique us", "choix moy. us", "IA");
+    for (int k = 0; k < argc; k++) {
+        GameState gs;
+        Solveur *sv = NULL;
+        if (charger_partie(&gs, argv[k]) && gs.in_progress)
+            sv = solveur_creer(&gs.cfg);
+        if (!sv) {
+            fprintf(stderr, "Sauvegarde inutilisable : %s\n", argv[k]);
+            erreurs++;
+            continue;
+        }
+        solveur_choisir_mode(sv, SOLVEUR_INCREMENTAL);
+
+        uint64_t t0 = horloge_ns();
+        int restants = solveur_appliquer_historique(sv, gs.guesses, gs.blacks,
+                                                    gs.whites, gs.tries);
+        uint64_t t_hist = horloge_ns() - t0;
+        int apres_historique = restants;
+
+        // L'IA joue jusqu'à la fin ; « G » si elle trouve dans les tentatives
+        int coups_ia = 0;
+        uint64_t t_choix = 0;
+        bool gagne = false;
+        while (restants > 0 && gs.tries + coups_ia < gs.cfg.max_tries) {
+            char g[CODE_LEN];
+            int b, w;
+            t0 = horloge_ns();
+            solveur_proposer(sv, g);
+            t_choix += horloge_ns() - t0;
+            coups_ia++;
+            calculer_feedback(gs.secret, g, &b, &w);
+            if (b == CODE_LEN) {
+                gagne = true;
+                break;
+            }
+            restants = solveur_filtrer(sv, g, b, w);
+        }
+        printf("%-24s %6d %10d %14.1f %14.1f %4d %s\n", argv[k], gs.tries,
+               apres_historique, (double)t_hist / 1e3,
+               coups_ia ? (double)t_choix / 1e3 / coups_ia : 0.0, coups_ia,
+               gagne ? "G" : "P");
+        solveur_detruire(sv);
+    }
+    return erreurs ? 1 : 0;
+}
+
+/* ============================================================
+   Roue de minuteurs
+   ============================================================ */
+
+static size_t compteur_rappels;
+
+static void rappel_compter(Minuteur *m, void *ctx) {
+    (void)m; (void)ctx;
+    compteur_rappels++;
+}
+
+// Armer, annuler la moitié puis déclencher le reste, sur des échéances
+// de 10 ms à 5 min comme pour des parties chronométrées.
+static void bench_minuteurs(size_t nb) {
+    Minuteur *ms = calloc(nb, sizeof(*ms));
+    uint64_t *echeances = malloc(nb * sizeof(*echeances));
+    Alea a;
+    alea_init(&a, 1);
+    for (size_t i=0;i<nb;i++)
+        echeances[i] = 10 + alea_borne(&a, 300000);
+
+    static RoueMinuteurs roue;
+    roue_init(&roue, 0);
+    compteur_rappels = 0;
+
+    uint64_t t0 = horloge_ns();
+    for (size_t i=0;i<nb;i++) roue_armer(&roue, &ms[i], echeances[i]);
+    uint64_t t1 = horloge_ns();
+    for (size_t i=0;i<nb;i+=2) roue_annuler(&roue, &ms[i]);
+    uint64_t t2 = horloge_ns();
+    for (uint64_t t=0; t<=300010; t+=ROUE_PAS_MS)
+        roue_avancer(&roue, t, rappel_compter, NULL);
+    uint64_t t3 = horloge_ns();
+
+    printf("minuteurs (%zu)\n", nb);
+    printf("  armer      : %8.1f Mops/s\n", (double)nb / (double)(t1 - t0) * 1e3);
+    printf("  annuler    : %8.1f Mops/s\n", (double)(nb / 2) / (double)(t2 - t1) * 1e3);
+    printf("  declencher : %8.1f Mops/s (%zu rappels, 30001 pas)\n",
+           (double)compteur_rappels / (double)(t3 - t2) * 1e3, compteur_rappels);
+    if (compteur_rappels != nb / 2) printf("  ERREUR: %zu rappels attendus\n", nb / 2);
+
+    // Roue vide : avancer ne coûte rien
+    t0 = horloge_ns();
+    for (uint64_t t=300010; t<=600010; t+=ROUE_PAS_MS)
+        roue_avancer(&roue, t, rappel_compter, NULL);
+    t1 = horloge_ns();
+    printf("  roue vide  : %8.1f ns par avance\n", (double)(t1 - t0) / 30001.0);
+
+    free(echeances);
+    free(ms);
+}
+
+int main(int argc, char **argv) {
+    const char *quoi = argc > 1 ? argv[1] : "noyaux";
+    if (strcmp(quoi, "noyaux") == 0)
+        return bench_noyaux(argc > 2 ? argc - 2 : 0, argv + 2);
+    if (strcmp(quoi, "tuiles") == 0)
+        return bench_tuiles();
+    if (strcmp(quoi, "reprise") == 0)
+        return bench_reprise(argc - 2, argv + 2);
+    if (strcmp(quoi, "minuteurs") == 0) {
+        bench_minuteurs(argc > 2 ? (size_t)atol(argv[2]) : 1000000);
+        return 0;
+    }
+    fprintf(stderr, "Mesure inconnue : %s\n", quoi);
+    return 1;
+}
@@ -0,0 +1,119 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache_feedback.h"
+
+/* ============================================================
+   Cache paresseux des feedbacks (lignes de 4 bits par code)
+   ============================================================ */
+
+_Static_assert(CODE_LEN == 4, "tables de cases prévues pour 4 positions");
+
+// Cases possibles noirs*5+blancs, numérotées de 0 à 13 ; 15 = inconnue
+const uint8_t CACHE_CASE_VERS_QUARTET[25] = {
+     0,  1,  2,  3,  4,     // 0 noir
+     5,  6,  7,  8, 15,     // 1 noir
+     9, 10, 11, 15, 15,     // 2 noirs
+    12, 15, 15, 15, 15,     // 3 noirs (3 noirs 1 blanc impossible)
+    13, 15, 15, 15, 15,     // 4 noirs
+};
+
+const uint8_t CACHE_QUARTET_VERS_CASE[16] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 11, 12, 15, 20,
+    CACHE_CASE_INCONNUE, CACHE_CASE_INCONNUE
+};
+
+struct CacheFeedback {
+    int nb_codes;
+    size_t taille_ligne;    // deux entrées par octet
+    size_t plafond;
+    int capacite;
+    int nb_lignes;
+    int aiguille;           // position du balayage d'éviction
+    int16_t *emplacement;   // proposition -> emplacement, -1 si absente
+    int16_t *proposition;   // emplacement -> proposition
+    uint8_t *reference;     // seconde chance : ligne relue depuis le passage
+    uint8_t *lignes;
+    uint64_t evictions;
+};
+
+CacheFeedback *cache_feedback_creer(int nb_codes, size_t plafond_octets)
+{
+    CacheFeedback *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    c->nb_codes = nb_codes;
+    c->taille_ligne = ((size_t)nb_codes + 1) / 2;
+    c->plafond = plafond_octets;
+    size_t capacite = c->taille_ligne ? plafond_octets / c->taille_ligne : 0;
+    c->capacite = capacite < (size_t)nb_codes ? (int)capacite : nb_codes;
+
+    c->emplacement = malloc((size_t)nb_codes * sizeof(c->emplacement[0]));
+    if (c->capacite > 0) {
+        c->proposition = malloc((size_t)c->capacite * sizeof(c->proposition[0]));
+        c->reference = calloc((size_t)c->capacite, 1);
+        // Réservé d'un bloc mais touché seulement ligne par ligne
+        c->lignes = malloc((size_t)c->capacite * c->taille_ligne);
+    }
+    if (!c->emplacement
+        || (c->capacite > 0 && (!c->proposition || !c->reference || !c->lignes))) {
+        cache_feedback_detruire(c);
+        return NULL;
+    }
+    for (int g = 0; g < nb_codes; g++) c->emplacement[g] = -1;
+    return c;
+}
+
+void cache_feedback_detruire(CacheFeedback *c)
+{
+    if (!c) return;
+    free(c->emplacement);
+    free(c->proposition);
+    free(c->reference);
+    free(c->lignes);
+    free(c);
+}
+
+// Emplacement à recycler : le premier sans seconde chance après l'aiguille
+static int choisir_victime(CacheFeedback *c)
+{
+    for (;;) {
+        int e = c->aiguille;
+        c->aiguille = (c->aiguille + 1) % c->capacite;
+        if (!c->reference[e]) return e;
+        c->reference[e] = 0;
+    }
+}
+
+uint8_t *cache_feedback_ligne(CacheFeedback *c, int g)
+{
+    int e = c->emplacement[g];
+    if (e >= 0) {
+        c->reference[e] = 1;
+        return c->lignes + (size_t)e * c->taille_ligne;
+    }
+    if (c->capacite == 0) return NULL;
+
+    if (c->nb_lignes < c->capacite) {
+        e = c->nb_lignes++;
+    } else {
+        e = choisir_victime(c);
+        c->emplacement[c->proposition[e]] = -1;
+        c->evictions++;
+    }
+    c->emplacement[g] = (int16_t)e;
+    c->proposition[e] = (int16_t)g;
+    c->reference[e] = 1;
+    uint8_t *ligne = c->lignes + (size_t)e * c->taille_ligne;
+    memset(ligne, 0xFF, c->taille_ligne);
+    return ligne;
+}
+
+void cache_feedback_infos(const CacheFeedback *c, InfosCache *out)
+{
+    out->nb_codes = c->nb_codes;
+    out->plafond = c->plafond;
+    out->octets = (size_t)c->nb_lignes * c->taille_ligne;
+    out->capacite = c->capacite;
+    out->lignes = c->nb_lignes;
+    out->evictions = c->evictions;
+}
@@ -0,0 +1,116 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "candidats.h"
+#include "feedback.h"
+#include "parse.h"
+#include "rang.h"
+#include "solveur_noyaux.h"
+
+/* ============================================================
+   Ensemble des codes compatibles, tassé (mode aide)
+   ============================================================ */
+
+struct Candidats {
+    int couleurs;
+    bool repetitions;
+    int nb;                 // survivants
+    int *rangs;             // rang de chaque survivant
+    SignatureCode *signatures;
+    uint64_t *presents;     // un bit par rang
+};
+
+static void retirer(Candidats *c, int rang)
+{
+    c->presents[rang >> 6] &= ~(1ULL << (rang & 63));
+}
+
+Candidats *candidats_creer(const GameConfig *cfg, const char propositions[][CODE_LEN],
+                           const int noirs[], const int blancs[], int nb)
+{
+    int n = nombre_codes(cfg->color_count, cfg->allow_repetition);
+    if (n <= 0) return NULL;
+    Candidats *c = malloc(sizeof(*c));
+    char (*codes)[CODE_LEN] = malloc((size_t)n * CODE_LEN);
+    bool *actif = malloc((size_t)n);
+    if (c) {
+        c->rangs = malloc((size_t)n * sizeof(c->rangs[0]));
+        c->signatures = malloc((size_t)n * sizeof(c->signatures[0]));
+        c->presents = calloc(((size_t)n + 63) / 64, sizeof(c->presents[0]));
+    }
+    if (!c || !codes || !actif || !c->rangs || !c->signatures || !c->presents) {
+        if (c) candidats_detruire(c);
+        free(codes);
+        free(actif);
+        return NULL;
+    }
+    c->couleurs = cfg->color_count;
+    c->repetitions = cfg->allow_repetition;
+
+    // Espace complet filtré en une passe par l'historique
+    generate_all_codes(codes, cfg);
+    SignatureCode *sig = c->signatures;
+    signer_codes(codes, n, sig);
+    memset(actif, true, (size_t)n);
+    if (nb > 0) {
+        SignatureCode props[MAX_TRIES_MAX];
+        uint8_t cases[MAX_TRIES_MAX];
+        if (nb > MAX_TRIES_MAX) nb = MAX_TRIES_MAX;
+        for (int j = 0; j < nb; j++)
+            cases[j] = signature_code(propositions[j], &props[j])
+                       ? (uint8_t)(noirs[j] * 5 + blancs[j]) : 0xFF;
+        CompteursSolveur cpt = {0};
+        filtrer_contraintes(sig, actif, n, props, cases, nb, &cpt);
+    }
+
+    // Tassement sur place : l'indice de lecture devance toujours l'écriture
+    c->nb = 0;
+    for (int r = 0; r < n; r++) {
+        if (!actif[r]) continue;
+        c->rangs[c->nb] = r;
+        sig[c->nb] = sig[r];
+        c->presents[r >> 6] |= 1ULL << (r & 63);
+        c->nb++;
+    }
+    free(codes);
+    free(actif);
+    return c;
+}
+
+void candidats_detruire(Candidats *c)
+{
+    if (!c) return;
+    free(c->rangs);
+    free(c->signatures);
+    free(c->presents);
+    free(c);
+}
+
+bool candidats_contient(const Candidats *c, const char code[CODE_LEN])
+{
+    int r = code_rang(code_compacter(code), c->couleurs, c->repetitions);
+    return r >= 0 && (c->presents[r >> 6] >> (r & 63)) & 1;
+}
+
+int candidats_filtrer(Candidats *c, const char guess[CODE_LEN], int noirs, int blancs)
+{
+    SignatureCode sg;
+    int attendue = signature_code(guess, &sg) ? noirs * 5 + blancs : -1;
+    int k = 0;
+    for (int i = 0; i < c->nb; i++) {
+        if (attendue >= 0 && case_signatures(c->signatures[i], sg) == attendue) {
+            c->rangs[k] = c->rangs[i];
+            c->signatures[k] = c->signatures[i];
+            k++;
+        } else {
+            retirer(c, c->rangs[i]);
+        }
+    }
+    c->nb = k;
+    return k;
+}
+
+int candidats_nombre(const Candidats *c)
+{
+    return c->nb;
+}
@@ -0,0 +1,234 @@
+/*
+ * Générateur de charge local pour `mastermind --serve`.
+ *
+ * Usage : charge <socket> [connexions] [sessions_par_connexion]
+ *
+ * Chaque thread ouvre une connexion, crée ses sessions (toutes actives en
+ * même temps côté serveur) puis joue des propositions aléatoires valides
+ * par vagues pipelinées jusqu'à la fin de toutes ses parties.
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include "types.h"
+#include "couleurs.h"
+
+// Requêtes par envoi ; au plus deux envois attendent leurs réponses, soit
+// bien moins que le plafond de sortie du serveur, qui cesse de lire une
+// connexion au-delà (un envoi bloquant de toute une vague s'y bloquerait).
+#define FENETRE 1024
+#define TAILLE_REPONSE 64
+
+typedef struct {
+    const char *chemin;
+    int nb_sessions;
+    unsigned graine;
+    unsigned long requetes;
+    unsigned long parties;
+    double *latences;       // une mesure par vague (secondes)
+    int nb_latences;
+    bool erreur;
+} Travail;
+
+typedef struct {
+    int fd;
+    char buf[65536];
+    size_t debut, fin;
+} Lecteur;
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static bool lire_reponse(Lecteur *l, char *ligne, size_t taille) {
+    for (;;) {
+        for (size_t i=l->debut;i<l->fin;i++) {
+            if (l->buf[i] != '\n') continue;
+            size_t n = i - l->debut;
+            if (n >= taille) n = taille - 1;
+            memcpy(ligne, l->buf + l->debut, n);
+            ligne[n] = '\0';
+            l->debut = i + 1;
+            return true;
+        }
+        memmove(l->buf, l->buf + l->debut, l->fin - l->debut);
+        l->fin -= l->debut;
+        l->debut = 0;
+        ssize_t n = recv(l->fd, l->buf + l->fin, sizeof(l->buf) - l->fin, 0);
+        if (n <= 0) return false;
+        l->fin += (size_t)n;
+    }
+}
+
+static bool envoyer_tout(int fd, const char *p, size_t n) {
+    while (n > 0) {
+        ssize_t k = send(fd, p, n, MSG_NOSIGNAL);
+        if (k <= 0) return false;
+        p += k; n -= (size_t)k;
+    }
+    return true;
+}
+
+// Envoie nb requêtes (une par ligne) par paquets de FENETRE, en lisant les
+// réponses de chaque paquet pendant que le serveur traite le suivant
+static bool echanger(Lecteur *l, const char *req, size_t taille, int nb,
+                     char (*rep)[TAILLE_REPONSE]) {
+    const char *p = req, *fin = req + taille;
+    int envoyees = 0, lues = 0;
+    while (lues < nb) {
+        int k = 0;
+        if (envoyees < nb) {
+            const char *q = p;
+            while (k < FENETRE && envoyees + k < nb) {
+                q = (const char *)memchr(q, '\n', (size_t)(fin - q)) + 1;
+                k++;
+            }
+            if (!envoyer_tout(l->fd, p, (size_t)(q - p))) return false;
+            p = q;
+            envoyees += k;
+        }
+        int attendu = envoyees < nb ? envoyees - k : nb;
+        for (; lues < attendu; lues++)
+            if (!lire_reponse(l, rep[lues], TAILLE_REPONSE)) return false;
+    }
+    return true;
+}
+
+static void *executer(void *arg) {
+    Travail *t = arg;
+    Lecteur *l = calloc(1, sizeof(*l));
+    unsigned long long *ids = calloc((size_t)t->nb_sessions, sizeof(*ids));
+    char (*rep)[TAILLE_REPONSE] = malloc((size_t)t->nb_sessions * TAILLE_REPONSE);
+    size_t cap = (size_t)t->nb_sessions * 32 + 64;
+    char *req = malloc(cap);
+    if (!l || !ids || !rep || !req) {
+        t->erreur = true;
+        free(l); free(ids); free(rep); free(req);
+        return NULL;
+    }
+
+    l->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un adr = { .sun_family = AF_UNIX };
+    snprintf(adr.sun_path, sizeof(adr.sun_path), "%s", t->chemin);
+    if (connect(l->fd, (struct sockaddr *)&adr, sizeof(adr)) != 0) {
+        t->erreur = true;
+        goto fin;
+    }
+
+    // Création de toutes les sessions en une seule vague
+    size_t n = 0;
+    for (int i=0;i<t->nb_sessions;i++) n += (size_t)sprintf(req + n, "NEW\n");
+    if (!echanger(l, req, n, t->nb_sessions, rep)) { t->erreur = true; goto fin; }
+    for (int i=0;i<t->nb_sessions;i++) {
+        if (sscanf(rep[i], "OK %llu", &ids[i]) != 1) { t->erreur = true; goto fin; }
+    }
+    t->requetes += (size_t)t->nb_sessions;
+
+    int actives = t->nb_sessions;
+    while (actives > 0) {
+        n = 0;
+        int envoyes = 0;
+        for (int i=0;i<t->nb_sessions;i++) {
+            if (!ids[i]) continue;
+            char pool[MAX_COLORS];
+            memcpy(pool, GLOBAL_COLOR_SET, MAX_COLORS);
+            for (int k=MAX_COLORS-1;k>0;k--) {
+                int j = rand_r(&t->graine) % (k+1);
+                char x = pool[k]; pool[k] = pool[j]; pool[j] = x;
+            }
+            n += (size_t)sprintf(req + n, "GUESS %llu %.*s\n", ids[i], CODE_LEN, pool);
+            envoyes++;
+        }
+        double t0 = maintenant();
+        if (!echanger(l, req, n, envoyes, rep)) { t->erreur = true; goto fin; }
+        for (int i=0, k=0;i<t->nb_sessions;i++) {
+            if (!ids[i]) continue;
+            t->requetes++;
+            if (strstr(rep[k++], "ENCOURS") == NULL) {
+                ids[i] = 0;
+                actives--;
+                t->parties++;
+            }
+        }
+        t->latences[t->nb_latences++] = maintenant() - t0;
+    }
+
+fin:
+    close(l->fd);
+    free(req);
+    free(rep);
+    free(ids);
+    free(l);
+    return NULL;
+}
+
+static int comparer(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <socket> [connexions] [sessions_par_connexion]\n", argv[0]);
+        return 1;
+    }
+    int nb_conn = argc > 2 ? atoi(argv[2]) : 8;
+    int par_conn = argc > 3 ? atoi(argv[3]) : 1000;
+    if (nb_conn < 1 || par_conn < 1) return 1;
+
+    Travail *ts = calloc((size_t)nb_conn, sizeof(*ts));
+    pthread_t *th = calloc((size_t)nb_conn, sizeof(*th));
+    double *lat = calloc((size_t)nb_conn * (MAX_TRIES_MAX + 1), sizeof(double));
+    if (!ts || !th || !lat) {
+        fprintf(stderr, "Memoire insuffisante\n");
+        return 1;
+    }
+    for (int i=0;i<nb_conn;i++) {
+        ts[i].chemin = argv[1];
+        ts[i].nb_sessions = par_conn;
+        ts[i].graine = 12345u + (unsigned)i;
+        ts[i].latences = calloc(MAX_TRIES_MAX + 1, sizeof(double));
+        if (!ts[i].latences) {
+            fprintf(stderr, "Memoire insuffisante\n");
+            return 1;
+        }
+    }
+
+    double t0 = maintenant();
+    for (int i=0;i<nb_conn;i++) pthread_create(&th[i], NULL, executer, &ts[i]);
+    for (int i=0;i<nb_conn;i++) pthread_join(th[i], NULL);
+    double duree = maintenant() - t0;
+
+    unsigned long requetes = 0, parties = 0;
+    int nb_lat = 0, erreurs = 0;
+    for (int i=0;i<nb_conn;i++) {
+        requetes += ts[i].requetes;
+        parties += ts[i].parties;
+        erreurs += ts[i].erreur;
+        for (int k=0;k<ts[i].nb_latences;k++) lat[nb_lat++] = ts[i].latences[k] / par_conn;
+        free(ts[i].latences);
+    }
+    qsort(lat, (size_t)nb_lat, sizeof(double), comparer);
+
+    printf("Sessions simultanees : %d (%d connexions x %d)\n",
+           nb_conn * par_conn, nb_conn, par_conn);
+    printf("Parties terminees    : %lu\n", parties);
+    printf("Requetes             : %lu en %.3fs (%.0f req/s)\n",
+           requetes, duree, requetes / duree);
+    if (nb_lat > 0)
+        printf("Temps par requete    : median %.2fus, p99 %.2fus (par vague)\n",
+               lat[nb_lat / 2] * 1e6, lat[(nb_lat * 99) / 100] * 1e6);
+    if (erreurs) printf("Connexions en erreur : %d\n", erreurs);
+
+    free(lat);
+    free(ts);
+    free(th);
+    return erreurs ? 1 : 0;
+}
@@ -1,20 +1,23 @@
-#include <time.h>
-#include <stdio.h>
 #include "chronometre.h"
-#include "utils.h"
-#include "parse.h"
+#include "horloge.h"
 
-bool saisie_minutee(char out_code[CODE_LEN],
-                    int color_count, bool allow_repetition,
-                    int time_limit_sec) {
-    time_t start = time(NULL);
-    char line[256];
-    if (!lire_ligne(line, sizeof(line))) return false;
-    time_t end = time(NULL);
-    double elapsed = difftime(end, start);
-    if (elapsed > (double)time_limit_sec) {
-        printf("Temps depasse (%.0fs > %ds). Tentative annulee.\n", elapsed, time_limit_sec);
-        return false;
+// Lecture d'une ligne avant une échéance sur l'horloge monotone ; à
+// l'échéance, ce qui a été tapé de la ligne est abandonné
+static ResultatLecture lire_ligne_avant(char *buffer, size_t buflen, uint64_t echeance_ms) {
+    for (;;) {
+        uint64_t t = horloge_ms();
+        if (t >= echeance_ms) {
+            abandonner_ligne();
+            return LECTURE_DELAI;
+        }
+        ResultatLecture r = lire_ligne_attente(buffer, buflen, (int)(echeance_ms - t));
+        if (r != LECTURE_DELAI) return r;
     }
-    return parser_proposition(line, out_code, color_count, allow_repetition);
+}
+
+// La tentative est abandonnée à l'échéance même si le joueur ne répond pas ;
+// l'appelant annonce le dépassement (LECTURE_DELAI) sur sa propre sortie
+ResultatLecture saisie_minutee(char *ligne, size_t taille, int time_limit_sec) {
+    uint64_t echeance = horloge_ms() + (uint64_t)time_limit_sec * 1000u;
+    return lire_ligne_avant(ligne, taille, echeance);
 }
@@ -12,7 +12,5 @@ void afficher_palette(int color_count) {
 }
 
 void afficher_code(const char code[CODE_LEN]) {
-    for (int i=0;i<CODE_LEN;i++) {
-        printf("%c", code[i]);
-    }
+    fwrite(code, 1, CODE_LEN, stdout);
 }
@@ -2,9 +2,35 @@
 #include <string.h>
 #include "feedback.h"
 
+/* Indice de couleur + 1 pour les lettres de GLOBAL_COLOR_SET (même
+   ordre), 0 pour tout autre octet */
+static const uint8_t COULEUR_OCTET[256] = {
+    ['R'] = 1, ['G'] = 2, ['B'] = 3, ['Y'] = 4, ['O'] = 5, ['P'] = 6,
+};
+
+bool signature_code(const char code[CODE_LEN], SignatureCode *out) {
+    uint32_t comptes = 0, positions = 0;
+    for (int i=0;i<CODE_LEN;i++) {
+        unsigned k = COULEUR_OCTET[(unsigned char)code[i]];
+        if (k == 0) return false;
+        comptes += 1u << (4 * (k - 1));
+        positions |= 1u << (8 * i + (k - 1));
+    }
+    out->comptes = comptes;
+    out->positions = positions;
+    return true;
+}
+
 void calculer_feedback(const char secret[CODE_LEN],
                        const char guess[CODE_LEN],
                        int *noirs, int *blancs) {
+    SignatureCode s, g;
+    if (signature_code(secret, &s) && signature_code(guess, &g)) {
+        feedback_signatures(s, g, noirs, blancs);
+        return;
+    }
+
+    // Lettres hors palette : comparaison caractère par caractère
     *noirs = 0;
     *blancs = 0;
 
@@ -19,19 +45,14 @@ void calculer_feedback(const char secret[CODE_LEN],
         }
     }
 
-    int sc[256] = {0};
-    int gc[256] = {0};
-
     for (int i=0;i<CODE_LEN;i++) {
-        if (!s_used[i]) sc[(unsigned char)secret[i]]++;
-        if (!g_used[i]) gc[(unsigned char)guess[i]]++;
-    }
-
-    int matches=0;
-    for (int c=0;c<256;c++) {
-        if (sc[c]>0 && gc[c]>0) {
-            matches += (sc[c] < gc[c] ? sc[c] : gc[c]);
+        if (s_used[i]) continue;
+        for (int j=0;j<CODE_LEN;j++) {
+            if (!g_used[j] && secret[i] == guess[j]) {
+                g_used[j] = true;
+                (*blancs)++;
+                break;
+            }
         }
     }
-    *blancs = matches;
 }
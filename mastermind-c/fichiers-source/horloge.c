@@ -0,0 +1,12 @@
+#include <time.h>
+#include "horloge.h"
+
+uint64_t horloge_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t horloge_ms(void) {
+    return horloge_ns() / 1000000ULL;
+}
@@ -1,237 +1,215 @@
 #include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
 #include <stdbool.h>
 
 #include "ia.h"
 #include "types.h"
 #include "couleurs.h"
-#include "feedback.h"
-#include "statistiques.h"
+#include "moteur.h"
+#include "alea.h"
+#include "solveur.h"
+#include "agregateur_stats.h"
+#include "rejeu.h"
+#include "sortie.h"
+#include "sauvegarde.h"
+#include "horloge.h"
 
 /* ============================================================
-   IA avancée (heuristique type Knuth)
+   Mode IA : affichage console autour du moteur et du solveur
    ============================================================ */
 
-// Compare deux codes via compute_feedback
-static void feedback_between(const char secret[CODE_LEN],
-                             const char guess[CODE_LEN],
-                             int *black, int *white)
-{
-    compute_feedback(secret, guess, black, white);
-}
+// Cache de feedbacks gardé d'une partie de l'IA à l'autre, pour la
+// dernière configuration jouée
+static size_t plafond_cache = IA_PLAFOND_CACHE_DEFAUT;
+static CacheFeedback *cache;
+static int cle_cache = -1;
 
-// Génère toutes les combinaisons possibles selon la config
-static int generate_all_codes(char codes[][CODE_LEN], const GameConfig *cfg)
+void ia_fixer_plafond_cache(size_t octets)
 {
-    int count = 0;
-
-    if (cfg->allow_repetition) {
-        for (int i0 = 0; i0 < cfg->color_count; i0++)
-        for (int i1 = 0; i1 < cfg->color_count; i1++)
-        for (int i2 = 0; i2 < cfg->color_count; i2++)
-        for (int i3 = 0; i3 < cfg->color_count; i3++) {
-            codes[count][0] = GLOBAL_COLOR_SET[i0];
-            codes[count][1] = GLOBAL_COLOR_SET[i1];
-            codes[count][2] = GLOBAL_COLOR_SET[i2];
-            codes[count][3] = GLOBAL_COLOR_SET[i3];
-            count++;
-        }
-    } else {
-        for (int i0 = 0; i0 < cfg->color_count; i0++)
-        for (int i1 = 0; i1 < cfg->color_count; i1++) if (i1 != i0)
-        for (int i2 = 0; i2 < cfg->color_count; i2++) if (i2 != i0 && i2 != i1)
-        for (int i3 = 0; i3 < cfg->color_count; i3++) if (i3 != i0 && i3 != i1 && i3 != i2) {
-            codes[count][0] = GLOBAL_COLOR_SET[i0];
-            codes[count][1] = GLOBAL_COLOR_SET[i1];
-            codes[count][2] = GLOBAL_COLOR_SET[i2];
-            codes[count][3] = GLOBAL_COLOR_SET[i3];
-            count++;
-        }
-    }
-
-    return count;
+    plafond_cache = octets;
+    cache_feedback_detruire(cache);
+    cache = NULL;
+    cle_cache = -1;
 }
 
-// Évalue un guess : on cherche la pire partition possible
-static int evaluate_guess(const char guess[CODE_LEN],
-                          char possibles[][CODE_LEN],
-                          const bool actif[],
-                          int nb_possibles)
+static CacheFeedback *cache_pour(const GameConfig *cfg, int nb_codes)
 {
-    int counts[25];
-    for (int i = 0; i < 25; i++) counts[i] = 0;
-
-    for (int i = 0; i < nb_possibles; i++) {
-        if (!actif[i]) continue;
-        int b, w;
-        feedback_between(possibles[i], guess, &b, &w);
-        counts[b * 5 + w]++;
+    int cle = cfg->color_count * 2 + (cfg->allow_repetition ? 1 : 0);
+    if (cle != cle_cache) {
+        cache_feedback_detruire(cache);
+        cache = plafond_cache ? cache_feedback_creer(nb_codes, plafond_cache) : NULL;
+        cle_cache = cle;
     }
-
-    int worst = 0;
-    for (int i = 0; i < 25; i++)
-        if (counts[i] > worst) worst = counts[i];
-
-    return worst;
+    return cache;
 }
 
-// Choisit la meilleure proposition
-static void choose_next_guess(char guess_out[CODE_LEN],
-                              char possibles[][CODE_LEN],
-                              bool actif[],
-                              int nb_possibles)
+// Joue jusqu'à la fin de la partie ; seul le temps joué depuis « deja_ns »
+// entre dans les statistiques
+static void finir_partie(Sortie *o, Session *s, Solveur *sv,
+                         AgregateurStats *st, uint64_t deja_ns)
 {
-    int best_score = 999999;
-    int best_index = -1;
+    const GameConfig *cfg = session_config(s);
+    EnregistrementPartie rec;
+    rejeu_debut(&rec, s, REJEU_IA);
+    ResultatCoup r = COUP_OK;
 
-    for (int i = 0; i < nb_possibles; i++) {
-        if (!actif[i]) continue;
+    while (r == COUP_OK) {
+        char guess[CODE_LEN];
+        CompteursSolveur avant, apres;
+        solveur_compteurs(sv, &avant);
+        solveur_proposer(sv, guess);
+        solveur_compteurs(sv, &apres);
 
-        int score = evaluate_guess(possibles[i], possibles, actif, nb_possibles);
-        if (score < best_score) {
-            best_score = score;
-            best_index = i;
+        int black = 0, white = 0;
+        r = session_proposer(s, guess, &black, &white);
+        rejeu_noter_coup(&rec, s);
+        int tries = session_tentatives(s);
+
+        sortie_printf(o, "IA Tentative %d/%d : %.*s  => ●: %d, ○: %d  "
+                         "(choix en %.3fms, %llu feedbacks)\n",
+                      tries, cfg->max_tries, CODE_LEN, guess, black, white,
+                      (double)(apres.ns_choix - avant.ns_choix) / 1e6,
+                      (unsigned long long)(apres.feedbacks - avant.feedbacks));
+
+        if (r == COUP_GAGNE) {
+            double elapsed = (double)(session_duree_ns(s) - deja_ns) / 1e9;
+            char secret[CODE_LEN];
+            session_secret(s, secret);
+
+            sortie_printf(o, "IA a trouvé le code en %d tentatives (%.3fms).\n"
+                             "Code secret : %.*s\n",
+                          tries, elapsed * 1000.0, CODE_LEN, secret);
+
+            // Les parties de l'IA ne comptent pas comme victoires du joueur
+            agregateur_enregistrer(st, false, tries, elapsed);
+            break;
         }
-    }
 
-    if (best_index == -1) {
-        for (int i = 0; i < nb_possibles; i++)
-            if (actif[i]) { best_index = i; break; }
-    }
-
-    memcpy(guess_out, possibles[best_index], CODE_LEN);
-}
+        int before = solveur_restants(sv);
+        solveur_compteurs(sv, &avant);
+        int after = solveur_filtrer(sv, guess, black, white);
+        solveur_compteurs(sv, &apres);
 
-// Filtre les possibilités selon le feedback
-static int filter_possibilities(char possibles[][CODE_LEN],
-                                bool actif[],
-                                int nb_possibles,
-                                const char guess[CODE_LEN],
-                                int black_expected,
-                                int white_expected)
-{
-    int count = 0;
-
-    for (int i = 0; i < nb_possibles; i++) {
-        if (!actif[i]) continue;
+        sortie_printf(o, "Raisonnement IA : %d possibilités -> %d après filtrage (%.3fms).\n",
+                      before, after, (double)(apres.ns_filtre - avant.ns_filtre) / 1e6);
 
-        int b, w;
-        feedback_between(possibles[i], guess, &b, &w);
+        char exemple[CODE_LEN];
+        if (solveur_exemple(sv, exemple))
+            sortie_printf(o, "Exemple de code encore possible: %.*s\n",
+                          CODE_LEN, exemple);
+        sortie_printf(o, "\n");
+        sortie_vider(o);    // une écriture par coup
+    }
 
-        if (b == black_expected && w == white_expected)
-            count++;
-        else
-            actif[i] = false;
+    if (r == COUP_PERDU) {
+        char secret[CODE_LEN];
+        session_secret(s, secret);
+        sortie_printf(o, "IA n'a pas trouvé le code.\n"
+                         "Le code secret était : %.*s\n", CODE_LEN, secret);
     }
 
-    return count;
+    CompteursSolveur total;
+    solveur_compteurs(sv, &total);
+    sortie_printf(o, "Coût du solveur : %llu feedbacks, %llu partitions "
+                     "(%llu coupées, %llu feedbacks évités), %llu en cache "
+                     "(%llu lignes recyclées), %.3fms de choix et %.3fms de filtrage.\n",
+                  (unsigned long long)total.feedbacks,
+                  (unsigned long long)total.partitions,
+                  (unsigned long long)total.evaluations_coupees,
+                  (unsigned long long)total.feedbacks_evites,
+                  (unsigned long long)total.cache_hits,
+                  (unsigned long long)total.lignes_evincees,
+                  (double)total.ns_choix / 1e6, (double)total.ns_filtre / 1e6);
+    sortie_vider(o);
+
+    rejeu_ecrire(&rec, REJEU_FICHIER);
 }
 
-// Exemple de possibilité restante
-static void print_one_example(char possibles[][CODE_LEN],
-                              const bool actif[],
-                              int nb_possibles)
+static Solveur *creer_solveur(const GameConfig *cfg)
 {
-    for (int i = 0; i < nb_possibles; i++) {
-        if (actif[i]) {
-            printf("Exemple de code encore possible: ");
-            print_code(possibles[i]);
-            printf("\n");
-            return;
-        }
-    }
+    Solveur *sv = solveur_creer(cfg);
+    if (!sv) return NULL;
+    // Les histogrammes du premier coup sont calculés une fois par processus
+    solveur_choisir_mode(sv, SOLVEUR_INCREMENTAL);
+    // Sans la mémoire demandée, l'IA calcule simplement chaque feedback
+    solveur_utiliser_cache(sv, cache_pour(cfg, solveur_taille_initiale(sv)));
+    return sv;
 }
 
-// Génère le secret pour l’IA
-static void generate_secret_ai(char secret[CODE_LEN],
-                               int color_count, bool allow_repetition)
+void jouer_ia(GameConfig cfg, AgregateurStats *st)
 {
-    if (allow_repetition) {
-        for (int i=0;i<CODE_LEN;i++)
-            secret[i] = GLOBAL_COLOR_SET[rand()%color_count];
-    } else {
-        char pool[MAX_COLORS];
-        for (int i=0;i<color_count;i++) pool[i]=GLOBAL_COLOR_SET[i];
-        for (int i=color_count-1;i>0;i--) {
-            int j = rand()%(i+1);
-            char t = pool[i]; pool[i]=pool[j]; pool[j]=t;
-        }
-        for (int k=0;k<CODE_LEN;k++) secret[k]=pool[k];
+    Sortie o;
+    sortie_init(&o, stdout);
+    sortie_printf(&o, "\n=== Mode IA (stratégie avancée) ===\n");
+    sortie_palette(&o, cfg.color_count);
+
+    Session *s = session_creer(&cfg, alea_graine_systeme());
+    Solveur *sv = s ? creer_solveur(&cfg) : NULL;
+    if (!s || !sv) {
+        sortie_printf(&o, "Configuration invalide pour l'IA.\n");
+        sortie_vider(&o);
+        session_detruire(s);
+        solveur_detruire(sv);
+        return;
     }
-}
 
-/* ============================================================
-   Fonction principale IA
-   ============================================================ */
-
-void play_ai(GameConfig cfg, Stats *st)
-{
-    printf("\n=== Mode IA (stratégie avancée) ===\n");
-    print_palette(cfg.color_count);
-
-    char secret[CODE_LEN];
-    generate_secret_ai(secret, cfg.color_count, cfg.allow_repetition);
-
-    printf("Secret: **** (masqué)\n\n");
-
-    char possibles[2000][CODE_LEN];
-    bool actif[2000];
-    int nb_possibles = generate_all_codes(possibles, &cfg);
-
-    for (int i = 0; i < nb_possibles; i++)
-        actif[i] = true;
-
-    printf("Nombre initial de possibilités : %d\n\n", nb_possibles);
-
-    int tries = 0;
-    time_t start = time(NULL);
-
-    while (tries < cfg.max_tries) {
-        char guess[CODE_LEN];
-        choose_next_guess(guess, possibles, actif, nb_possibles);
-
-        int black = 0, white = 0;
-        compute_feedback(secret, guess, &black, &white);
-        tries++;
-
-        printf("IA Tentative %d/%d : ", tries, cfg.max_tries);
-        print_code(guess);
-        printf("  => ●: %d, ○: %d\n", black, white);
-
-        if (black == CODE_LEN) {
-            time_t end = time(NULL);
-            double elapsed = difftime(end, start);
-
-            printf("IA a trouvé le code en %d tentatives.\n", tries);
-            printf("Code secret : ");
-            print_code(secret);
-            printf("\n");
-
-            st->games_played++;
-            st->total_tries += tries;
-            st->total_time += elapsed;
-            save_stats(st, "stats.txt");
-            return;
-        }
-
-        int before = 0;
-        for (int i = 0; i < nb_possibles; i++)
-            if (actif[i]) before++;
-
-        int after = filter_possibilities(possibles, actif, nb_possibles,
-                                         guess, black, white);
+    sortie_printf(&o, "Secret: **** (masqué)\n\n");
+    sortie_printf(&o, "Nombre initial de possibilités : %d\n\n", solveur_taille_initiale(sv));
+    sortie_vider(&o);
 
-        printf("Raisonnement IA : %d possibilités -> %d après filtrage.\n",
-               before, after);
+    finir_partie(&o, s, sv, st, 0);
+    solveur_detruire(sv);
+    session_detruire(s);
+}
 
-        print_one_example(possibles, actif, nb_possibles);
-        printf("\n");
+void ia_reprendre_partie(AgregateurStats *st)
+{
+    GameState gs;
+    Session *s = NULL;
+    if (charger_partie(&gs, "save.txt") && gs.in_progress)
+        s = session_depuis_etat(&gs);
+    if (!s || session_etat(s) != PARTIE_EN_COURS) {
+        printf("Aucune sauvegarde disponible.\n");
+        session_detruire(s);
+        return;
+    }
+    const GameConfig *cfg = session_config(s);
+    Solveur *sv = creer_solveur(cfg);
+
+    Sortie o;
+    sortie_init(&o, stdout);
+    sortie_printf(&o, "\n=== L'IA reprend la partie sauvegardée ===\n");
+    sortie_palette(&o, cfg->color_count);
+    if (!sv) {
+        sortie_printf(&o, "Configuration invalide pour l'IA.\n");
+        sortie_vider(&o);
+        session_detruire(s);
+        return;
     }
 
-    printf("IA n'a pas trouvé le code.\n");
-    printf("Le code secret était : ");
-    print_code(secret);
-    printf("\n");
+    // Les candidats sont ceux qui expliquent tout l'historique
+    int nb = session_tentatives(s);
+    char propositions[MAX_TRIES_MAX][CODE_LEN];
+    int noirs[MAX_TRIES_MAX], blancs[MAX_TRIES_MAX];
+    for (int i = 0; i < nb; i++)
+        session_coup(s, i, propositions[i], &noirs[i], &blancs[i]);
+    uint64_t t0 = horloge_ns();
+    int restants = solveur_appliquer_historique(sv, propositions, noirs, blancs, nb);
+    uint64_t duree = horloge_ns() - t0;
+
+    sortie_printf(&o, "Secret: **** (masqué)\n");
+    sortie_printf(&o, "Historique : %d tentatives sur %d, %d possibilités sur %d "
+                      "(filtré en %.3fms).\n\n",
+                  nb, cfg->max_tries, restants, solveur_taille_initiale(sv),
+                  (double)duree / 1e6);
+    sortie_vider(&o);
+
+    if (restants == 0) {
+        sortie_printf(&o, "Historique incohérent : aucun code possible.\n");
+        sortie_vider(&o);
+    } else {
+        // save.txt reste en place : la même position peut être rejouée
+        finir_partie(&o, s, sv, st, session_duree_ns(s));
+    }
+    solveur_detruire(sv);
+    session_detruire(s);
 }
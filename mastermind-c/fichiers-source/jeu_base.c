@@ -1,26 +1,15 @@
 #include <stdio.h>
-#include <stdlib.h>
-#include <time.h>
 #include <string.h>
 #include "types.h"
 #include "couleurs.h"
 #include "parse.h"
 #include "feedback.h"
 #include "utils.h"
-
-static void generer_secret_base(char secret[CODE_LEN]) {
-    char pool[MAX_COLORS];
-    int color_count = 6;
-    for (int i=0;i<color_count;i++) pool[i]=GLOBAL_COLOR_SET[i];
-    for (int i=color_count-1;i>0;i--) {
-        int j = rand()%(i+1);
-        char t = pool[i]; pool[i]=pool[j]; pool[j]=t;
-    }
-    for (int k=0;k<CODE_LEN;k++) secret[k]=pool[k];
-}
+#include "alea.h"
 
 void lancer_jeu_base(void) {
-    srand((unsigned int)time(NULL));
+    Alea alea;
+    alea_init(&alea, alea_graine_systeme());
 
     printf("=== Mastermind (Jeu de base) ===\n\n");
     afficher_palette(6);
@@ -28,7 +17,7 @@ void lancer_jeu_base(void) {
     printf("Feedback: noirs = bien places, blancs = bonne couleur, mauvaise position.\n\n");
 
     char secret[CODE_LEN];
-    generer_secret_base(secret);
+    generer_secret(secret, 6, false, &alea);
 
     char history_guess[10][CODE_LEN];
     int history_black[10];
@@ -1,152 +1,250 @@
 #include <stdio.h>
 #include <string.h>
-#include <time.h>
-#include <stdlib.h>
 #include "jeu_humain.h"
 #include "couleurs.h"
-#include "parse.h"
-#include "feedback.h"
+#include "moteur.h"
+#include "alea.h"
 #include "chronometre.h"
 #include "sauvegarde.h"
-#include "statistiques.h"
+#include "agregateur_stats.h"
+#include "rejeu.h"
 #include "utils.h"
+#include "sortie.h"
+#include "candidats.h"
 
-static void generer_secret(char secret[CODE_LEN],
-                           int color_count, bool allow_repetition) {
-    if (allow_repetition) {
-        for (int i=0;i<CODE_LEN;i++)
-            secret[i] = GLOBAL_COLOR_SET[rand()%color_count];
-    } else {
-        char pool[MAX_COLORS];
-        for (int i=0;i<color_count;i++) pool[i]=GLOBAL_COLOR_SET[i];
-        for (int i=color_count-1;i>0;i--) {
-            int j=rand()%(i+1);
-            char t=pool[i]; pool[i]=pool[j]; pool[j]=t;
-        }
-        for (int k=0;k<CODE_LEN;k++) secret[k]=pool[k];
+// Mode aide : codes encore possibles affichés après chaque coup
+static bool aide_active = false;
+
+void jeu_humain_fixer_aide(bool active) {
+    aide_active = active;
+}
+
+static void afficher_historique(Sortie *o, const Session *s) {
+    sortie_printf(o, "Historique des essais:\n");
+    for (int i=0;i<session_tentatives(s);i++) {
+        char code[CODE_LEN]; int noirs, blancs;
+        session_coup(s, i, code, &noirs, &blancs);
+        sortie_printf(o, "  %2d) %.*s  => noirs: %d, blancs: %d\n",
+                      i+1, CODE_LEN, code, noirs, blancs);
     }
 }
 
-static void afficher_historique(const GameState *gs) {
-    printf("Historique des essais:\n");
-    for (int i=0;i<gs->tries;i++) {
-        printf("  %2d) ", i+1);
-        afficher_code(gs->guesses[i]);
-        printf("  => noirs: %d, blancs: %d\n",
-               gs->blacks[i], gs->whites[i]);
+static void bannière(Sortie *o) {
+    sortie_printf(o, "\n=====================================\n"
+                     "        Mastermind - Avance          \n"
+                     "=====================================\n\n");
+}
+
+// Vide la sortie du tour, puis lit une proposition (chronométrée ou non)
+// et la soumet au moteur
+static ResultatCoup saisir_et_proposer(Sortie *o, Session *s) {
+    const GameConfig *cfg = session_config(s);
+    sortie_vider(o);
+    char line[256];
+    if (cfg->timed_mode) {
+        ResultatLecture r = saisie_minutee(line, sizeof(line), cfg->time_per_try_sec);
+        if (r == LECTURE_DELAI)
+            sortie_printf(o, "\nTemps depasse (%ds). Tentative annulee.\n",
+                          cfg->time_per_try_sec);
+        if (r != LECTURE_OK) return COUP_INVALIDE;
+    } else if (!lire_ligne(line, sizeof(line))) {
+        sortie_printf(o, "Lecture invalide.\n");
+        return COUP_INVALIDE;
     }
+    return session_proposer_texte(s, line, NULL, NULL);
 }
 
-static void bannière(void) {
-    printf("\n=====================================\n");
-    printf("        Mastermind - Avance          \n");
-    printf("=====================================\n\n");
+static void afficher_dernier_coup(Sortie *o, const Session *s) {
+    int i = session_tentatives(s) - 1;
+    char guess[CODE_LEN]; int noirs, blancs;
+    session_coup(s, i, guess, &noirs, &blancs);
+    sortie_printf(o, "Vous avez propose: %.*s  => noirs: %d, blancs: %d  (%.3fs)\n",
+                  CODE_LEN, guess, noirs, blancs,
+                  (double)session_duree_coup_ns(s, i) / 1e9);
 }
 
-void jouer_humain(GameConfig cfg, Stats *st) {
-    GameState gs;
-    memset(&gs, 0, sizeof(gs));
-    gs.cfg = cfg;
-    gs.in_progress = true;
-
-    srand((unsigned int)time(NULL));
-
-    bannière();
-    afficher_palette(cfg.color_count);
-    printf("Objectif: devinez le code (%d lettres) en %d tentatives.\n",
-           CODE_LEN, cfg.max_tries);
-    printf("Options: repetitions %s, chrono %s",
-           cfg.allow_repetition?"ON":"OFF",
-           cfg.timed_mode?"ON":"OFF");
-    if (cfg.timed_mode) printf(" (%ds)", cfg.time_per_try_sec);
-    printf("\nFeedback: noirs = bien places, blancs = bonne couleur, mauvaise position.\n\n");
-
-    generer_secret(gs.secret, cfg.color_count, cfg.allow_repetition);
-
-    time_t start_part = time(NULL);
-
-    while (gs.tries < cfg.max_tries) {
-        printf("Tentative %d/%d - Votre proposition: ",
-               gs.tries+1, cfg.max_tries);
-
-        char guess[CODE_LEN];
-        bool ok=false;
-
-        if (cfg.timed_mode) {
-            ok = saisie_minutee(guess, cfg.color_count,
-                                cfg.allow_repetition, cfg.time_per_try_sec);
-        } else {
-            char line[256];
-            if (!lire_ligne(line, sizeof(line))) {
-                printf("Lecture invalide.\n");
-                continue;
-            }
-            ok = parser_proposition(line, guess,
-                                    cfg.color_count, cfg.allow_repetition);
-        }
+// Ensemble des codes compatibles avec les coups déjà joués
+static Candidats *aide_ouvrir(Sortie *o, const Session *s) {
+    char props[MAX_TRIES_MAX][CODE_LEN];
+    int noirs[MAX_TRIES_MAX], blancs[MAX_TRIES_MAX];
+    int nb = session_tentatives(s);
+    for (int i=0;i<nb;i++)
+        session_coup(s, i, props[i], &noirs[i], &blancs[i]);
+    Candidats *c = candidats_creer(session_config(s), props, noirs, blancs, nb);
+    if (!c) {
+        sortie_printf(o, "Aide indisponible.\n");
+        return NULL;
+    }
+    sortie_printf(o, "Aide: %d code(s) encore possible(s).\n", candidats_nombre(c));
+    return c;
+}
+
+// Le dernier coup réduit l'ensemble du tour précédent : le coût suit le
+// nombre de candidats restants, pas la taille de l'espace
+static void afficher_aide(Sortie *o, Candidats *c, const Session *s) {
+    int i = session_tentatives(s) - 1;
+    char guess[CODE_LEN]; int noirs, blancs;
+    session_coup(s, i, guess, &noirs, &blancs);
+    bool coherente = candidats_contient(c, guess);
+    int reste = candidats_filtrer(c, guess, noirs, blancs);
+    sortie_printf(o, "Aide: %d code(s) encore possible(s), proposition %s l'historique.\n",
+                  reste, coherente ? "compatible avec" : "incompatible avec");
+}
+
+static void afficher_fin(Sortie *o, const Session *s) {
+    char secret[CODE_LEN];
+    session_secret(s, secret);
+    if (session_etat(s) == PARTIE_GAGNEE) {
+        sortie_printf(o, "Bravo ! Code trouve en %d tentative(s) et %.3fs.\n"
+                         "Code secret: %.*s\n",
+                      session_tentatives(s), (double)session_duree_ns(s) / 1e9,
+                      CODE_LEN, secret);
+    } else {
+        sortie_printf(o, "Dommage ! Vous n'avez pas trouve le code.\n"
+                         "Le code secret etait: %.*s\n", CODE_LEN, secret);
+    }
+    sortie_vider(o);
+}
+
+void jouer_humain(GameConfig cfg, AgregateurStats *st) {
+    Session *s = session_creer(&cfg, alea_graine_systeme());
+    if (!s) {
+        printf("Configuration invalide.\n");
+        return;
+    }
 
-        if (!ok) {
-            printf("Entree invalide ou hors temps. Rappel: %d lettres parmi ",
-                   CODE_LEN);
+    Sortie o;
+    sortie_init(&o, stdout);
+    bannière(&o);
+    sortie_palette(&o, cfg.color_count);
+    sortie_printf(&o, "Objectif: devinez le code (%d lettres) en %d tentatives.\n",
+                  CODE_LEN, cfg.max_tries);
+    sortie_printf(&o, "Options: repetitions %s, chrono %s",
+                  cfg.allow_repetition?"ON":"OFF",
+                  cfg.timed_mode?"ON":"OFF");
+    if (cfg.timed_mode) sortie_printf(&o, " (%ds)", cfg.time_per_try_sec);
+    sortie_printf(&o, "\nFeedback: noirs = bien places, blancs = bonne couleur, mauvaise position.\n\n");
+
+    EnregistrementPartie rec;
+    rejeu_debut(&rec, s, REJEU_HUMAIN);
+    Candidats *aide = aide_active ? aide_ouvrir(&o, s) : NULL;
+
+    while (session_etat(s) == PARTIE_EN_COURS) {
+        sortie_printf(&o, "Tentative %d/%d - Votre proposition: ",
+                      session_tentatives(s)+1, cfg.max_tries);
+
+        ResultatCoup r = saisir_et_proposer(&o, s);
+
+        if (r == COUP_INVALIDE) {
+            sortie_printf(&o, "Entree invalide ou hors temps. Rappel: %d lettres parmi ",
+                          CODE_LEN);
             for (int i=0;i<cfg.color_count;i++) {
-                printf("%c%s", GLOBAL_COLOR_SET[i],
-                       (i+1<cfg.color_count)?" ":"");
+                sortie_printf(&o, "%c%s", GLOBAL_COLOR_SET[i],
+                              (i+1<cfg.color_count)?" ":"");
             }
-            printf(", %s repetition.\n\n",
-                   cfg.allow_repetition?"avec":"sans");
-            printf("Tapez 'save' pour sauvegarder la partie, ou reessayez.\n");
+            sortie_printf(&o, ", %s repetition.\n\n",
+                          cfg.allow_repetition?"avec":"sans");
+            sortie_printf(&o, "Tapez 'save' pour sauvegarder la partie, ou reessayez.\n");
             continue;
         }
+        rejeu_noter_coup(&rec, s);
 
-        int noirs=0, blancs=0;
-        calculer_feedback(gs.secret, guess, &noirs, &blancs);
-
-        memcpy(gs.guesses[gs.tries], guess, CODE_LEN);
-        gs.blacks[gs.tries]=noirs;
-        gs.whites[gs.tries]=blancs;
-        gs.tries++;
-
-        printf("Vous avez propose: ");
-        afficher_code(guess);
-        printf("  => noirs: %d, blancs: %d\n", noirs, blancs);
-        afficher_historique(&gs);
-        printf("\n");
-
-        if (noirs == CODE_LEN) {
-            time_t end_part = time(NULL);
-            double elapsed = difftime(end_part, start_part);
-            printf("Bravo ! Code trouve en %d tentative(s).\n", gs.tries);
-            printf("Code secret: "); afficher_code(gs.secret); printf("\n");
-            st->games_played++;
-            st->games_won++;
-            st->total_tries += gs.tries;
-            st->total_time += elapsed;
-            sauvegarder_stats(st, "stats.txt");
-            gs.in_progress=false;
-            return;
-        }
+        afficher_dernier_coup(&o, s);
+        afficher_historique(&o, s);
+        if (aide) afficher_aide(&o, aide, s);
+        sortie_printf(&o, "\n");
+
+        if (r != COUP_OK) break;
 
-        printf("Commande (enter pour continuer) [save/quit]: ");
+        sortie_printf(&o, "Commande (enter pour continuer) [save/quit/aide]: ");
+        sortie_vider(&o);
         char cmd[32];
         if (lire_ligne(cmd, sizeof(cmd))) {
             if (strcmp(cmd,"save")==0) {
+                GameState gs;
+                session_vers_etat(s, &gs);
                 if (sauvegarder_partie(&gs, "save.txt"))
-                    printf("Partie sauvegardee.\n");
+                    sortie_printf(&o, "Partie sauvegardee.\n");
                 else
-                    printf("Echec sauvegarde.\n");
+                    sortie_printf(&o, "Echec sauvegarde.\n");
             } else if (strcmp(cmd,"quit")==0) {
-                printf("Abandon de la partie.\n");
+                sortie_printf(&o, "Abandon de la partie.\n");
                 break;
+            } else if (strcmp(cmd,"aide")==0) {
+                if (aide) {
+                    candidats_detruire(aide);
+                    aide = NULL;
+                    sortie_printf(&o, "Aide desactivee.\n");
+                } else {
+                    aide = aide_ouvrir(&o, s);
+                }
             }
         }
     }
 
-    time_t end_part = time(NULL);
-    double elapsed = difftime(end_part, start_part);
-    printf("Dommage ! Vous n'avez pas trouve le code.\n");
-    printf("Le code secret etait: "); afficher_code(gs.secret); printf("\n");
-    st->games_played++;
-    st->total_tries += gs.tries;
-    st->total_time += elapsed;
-    sauvegarder_stats(st, "stats.txt");
+    double elapsed = (double)session_duree_ns(s) / 1e9;
+    afficher_fin(&o, s);
+    agregateur_enregistrer(st, session_etat(s) == PARTIE_GAGNEE,
+                           session_tentatives(s), elapsed);
+    rejeu_ecrire(&rec, REJEU_FICHIER);
+    candidats_detruire(aide);
+    session_detruire(s);
+}
+
+void reprendre_partie(AgregateurStats *st) {
+    GameState gs;
+    Session *s = NULL;
+    if (charger_partie(&gs, "save.txt") && gs.in_progress)
+        s = session_depuis_etat(&gs);
+    if (!s || session_etat(s) != PARTIE_EN_COURS) {
+        printf("Aucune sauvegarde disponible.\n");
+        session_detruire(s);
+        return;
+    }
+    const GameConfig *cfg = session_config(s);
+
+    Sortie o;
+    sortie_init(&o, stdout);
+    sortie_printf(&o, "\nReprise de partie. Tentatives deja effectuees: %d/%d\n",
+                  session_tentatives(s), cfg->max_tries);
+    sortie_palette(&o, cfg->color_count);
+    afficher_historique(&o, s);
+    Candidats *aide = aide_active ? aide_ouvrir(&o, s) : NULL;
+    sortie_printf(&o, "\n");
+
+    EnregistrementPartie rec;
+    rejeu_debut(&rec, s, REJEU_HUMAIN);
+    // Seul le temps joué depuis la reprise entre dans les statistiques
+    uint64_t deja_ns = session_duree_ns(s);
+
+    while (session_etat(s) == PARTIE_EN_COURS) {
+        sortie_printf(&o, "Tentative %d/%d - Votre proposition: ",
+                      session_tentatives(s)+1, cfg->max_tries);
+        ResultatCoup r = saisir_et_proposer(&o, s);
+        if (r == COUP_INVALIDE) {
+            sortie_printf(&o, "Entree invalide ou hors temps.\n");
+            continue;
+        }
+        rejeu_noter_coup(&rec, s);
+
+        afficher_dernier_coup(&o, s);
+        if (aide) afficher_aide(&o, aide, s);
+
+        if (r == COUP_GAGNE) {
+            FILE *f=fopen("save.txt","w");
+            if (f) fclose(f);
+            break;
+        }
+
+        session_vers_etat(s, &gs);
+        sauvegarder_partie(&gs, "save.txt");
+    }
+
+    double elapsed = (double)(session_duree_ns(s) - deja_ns) / 1e9;
+    afficher_fin(&o, s);
+    agregateur_enregistrer(st, session_etat(s) == PARTIE_GAGNEE,
+                           session_tentatives(s), elapsed);
+    rejeu_ecrire(&rec, REJEU_FICHIER);
+    candidats_detruire(aide);
+    session_detruire(s);
 }
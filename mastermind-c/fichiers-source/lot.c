@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "lot.h"
+#include "moteur.h"
+#include "parse.h"
+#include "horloge.h"
+
+/* ============================================================
+   Mode lot : lecture par blocs, résultats dans un tampon de sortie
+   ============================================================ */
+
+#define LOT_TAMPON (1 << 20)
+#define LOT_MAX_LIGNE 4096      // au-delà, la ligne est refusée
+
+typedef struct {
+    FILE *f;
+    char buf[LOT_TAMPON];
+    size_t n;
+} SortieLot;
+
+static void sortie_vider(SortieLot *o) {
+    if (o->n) fwrite(o->buf, 1, o->n, o->f);
+    o->n = 0;
+}
+
+// Réserve de quoi écrire une ligne de résultat complète
+static char *sortie_reserver(SortieLot *o, size_t taille) {
+    if (o->n + taille > sizeof(o->buf)) sortie_vider(o);
+    return o->buf + o->n;
+}
+
+static void refuser_ligne(SortieLot *o, RapportLot *r) {
+    memcpy(sortie_reserver(o, 4), "! 0\n", 4);
+    o->n += 4;
+    r->parties++;
+    r->invalides++;
+}
+
+static bool est_blanc(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Prochain jeton de la ligne, lu sur place : renvoie sa longueur (0 en fin)
+static size_t jeton_suivant(const char **p, const char *fin, const char **jeton) {
+    const char *d = *p;
+    while (d < fin && est_blanc(*d)) d++;
+    const char *e = d;
+    while (e < fin && !est_blanc(*e)) e++;
+    *jeton = d;
+    *p = e;
+    return (size_t)(e - d);
+}
+
+static Session *ouvrir_partie(const char *jeton, size_t n, const GameConfig *cfg) {
+    if (jeton[0] == '@') {
+        if (n < 2 || n > 21) return NULL;
+        uint64_t graine = 0;
+        for (size_t i=1;i<n;i++) {
+            if (jeton[i] < '0' || jeton[i] > '9') return NULL;
+            graine = graine * 10 + (uint64_t)(jeton[i] - '0');
+        }
+        return session_creer(cfg, graine);
+    }
+    GameState gs;
+    CodeCompact v;
+    memset(&gs, 0, sizeof(gs));
+    gs.cfg = *cfg;
+    gs.in_progress = true;
+    if (!parser_compact(jeton, n, cfg->color_count, cfg->allow_repetition, &v))
+        return NULL;
+    code_decompacter(v, gs.secret);
+    return session_depuis_etat(&gs);
+}
+
+// Joue une ligne et écrit son résultat
+static void jouer_ligne(const char *ligne, const char *fin, const GameConfig *cfg,
+                        SortieLot *o, RapportLot *r) {
+    const char *p = ligne, *premier, *jeton;
+    size_t n = jeton_suivant(&p, fin, &premier);
+    if (n == 0 || premier[0] == '#') return;
+
+    // État, tentatives et au plus deux caractères par jeton restant
+    char *out = sortie_reserver(o, 16 + (size_t)(fin - ligne));
+    size_t k = 0;
+    Session *s = ouvrir_partie(premier, n, cfg);
+    if (!s) {
+        refuser_ligne(o, r);
+        return;
+    }
+    r->parties++;
+
+    char fb[LOT_MAX_LIGNE + 2];        // au plus un jeton tous les deux octets
+    size_t nfb = 0;
+    while ((n = jeton_suivant(&p, fin, &jeton)) != 0) {
+        int noirs = 0, blancs = 0;
+        char code[CODE_LEN];
+        CodeCompact v;
+        ResultatCoup res = COUP_INVALIDE;
+        if (parser_compact(jeton, n, cfg->color_count, cfg->allow_repetition, &v)) {
+            code_decompacter(v, code);
+            res = session_proposer(s, code, &noirs, &blancs);
+        } else if (session_etat(s) != PARTIE_EN_COURS) {
+            res = COUP_TERMINE;
+        }
+        if (res == COUP_TERMINE) break;
+        if (res == COUP_INVALIDE || res == COUP_HORS_DELAI) {
+            r->invalides++;
+            fb[nfb++] = 'x';
+            fb[nfb++] = 'x';
+            continue;
+        }
+        r->coups++;
+        fb[nfb++] = (char)('0' + noirs);
+        fb[nfb++] = (char)('0' + blancs);
+    }
+
+    static const char ETATS[] = { 'E', 'G', 'P' };
+    out[k++] = ETATS[session_etat(s)];
+    out[k++] = ' ';
+    k += (size_t)sprintf(out + k, "%d", session_tentatives(s));
+    if (nfb) {
+        out[k++] = ' ';
+        memcpy(out + k, fb, nfb);
+        k += nfb;
+    }
+    out[k++] = '\n';
+    o->n += k;
+    session_detruire(s);
+}
+
+bool executer_lot(FILE *entree, FILE *sortie, const GameConfig *cfg, RapportLot *r) {
+    memset(r, 0, sizeof(*r));
+    static char buf[LOT_TAMPON];
+    static SortieLot o;
+    o.f = sortie;
+    o.n = 0;
+
+    uint64_t t0 = horloge_ns();
+    size_t n = 0;
+    bool trop_longue = false;   // reste d'une ligne refusée à ignorer
+    for (;;) {
+        size_t lu = fread(buf + n, 1, sizeof(buf) - n, entree);
+        n += lu;
+        bool fin_flux = lu == 0;
+
+        char *debut = buf, *limite = buf + n;
+        for (;;) {
+            char *nl = memchr(debut, '\n', (size_t)(limite - debut));
+            if (!nl) break;
+            if (trop_longue) {
+                trop_longue = false;
+            } else if (nl - debut > LOT_MAX_LIGNE) {
+                refuser_ligne(&o, r);
+            } else {
+                jouer_ligne(debut, nl, cfg, &o, r);
+            }
+            debut = nl + 1;
+        }
+
+        size_t reste = (size_t)(limite - debut);
+        if (fin_flux) {
+            // Dernière ligne sans '\n'
+            if (reste && !trop_longue) {
+                if (reste <= LOT_MAX_LIGNE) {
+                    jouer_ligne(debut, limite, cfg, &o, r);
+                } else {
+                    refuser_ligne(&o, r);
+                }
+            }
+            break;
+        }
+        if (reste > LOT_MAX_LIGNE) {
+            if (!trop_longue) {
+                refuser_ligne(&o, r);
+            }
+            trop_longue = true;
+            reste = 0;
+        }
+        memmove(buf, debut, reste);
+        n = reste;
+    }
+
+    sortie_vider(&o);
+    fflush(sortie);
+    r->duree_sec = (double)(horloge_ns() - t0) / 1e9;
+    return !ferror(entree) && !ferror(sortie);
+}
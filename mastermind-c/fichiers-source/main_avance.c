@@ -1,6 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "menu.h"
+#include "serveur.h"
+#include "rejeu.h"
+#include "trace.h"
+#include "lot.h"
+#include "configuration.h"
+#include "sortie.h"
+#include "ia.h"
+#include "jeu_humain.h"
 
-int main(void) {
+static int rejouer(const char *chemin) {
+    RapportRejeu r;
+    bool ok = rejouer_fichier(chemin, &r);
+    if (!ok && r.parties == 0) {
+        fprintf(stderr, "Impossible de lire %s\n", chemin);
+        return 1;
+    }
+    printf("Parties rejouees : %lu (%lu coups) en %.3fs",
+           r.parties, r.coups, r.duree_sec);
+    if (r.duree_sec > 0.0)
+        printf(" - %.0f parties/s, %.0f coups/s",
+               (double)r.parties / r.duree_sec, (double)r.coups / r.duree_sec);
+    printf("\nDivergences     : %lu%s\n", r.divergences,
+           ok ? "" : " (fichier tronque ou corrompu)");
+    return (ok && r.divergences == 0) ? 0 : 2;
+}
+
+// --batch [couleurs [tentatives [repetitions 0|1]]] : parties lues sur stdin
+static int lot(int argc, char **argv) {
+    GameConfig cfg;
+    config_defaut(&cfg);
+    if (argc > 0) cfg.color_count = atoi(argv[0]);
+    if (argc > 1) cfg.max_tries = atoi(argv[1]);
+    if (argc > 2) cfg.allow_repetition = atoi(argv[2]) != 0;
+
+    RapportLot r;
+    bool ok = executer_lot(stdin, stdout, &cfg, &r);
+    fprintf(stderr, "Lot : %lu parties, %lu coups, %lu refus en %.3fs",
+            r.parties, r.coups, r.invalides, r.duree_sec);
+    if (r.duree_sec > 0.0)
+        fprintf(stderr, " - %.0f parties/s, %.0f coups/s",
+                (double)r.parties / r.duree_sec, (double)r.coups / r.duree_sec);
+    fprintf(stderr, "\n");
+    return ok ? 0 : 1;
+}
+
+static int lancer(int argc, char **argv) {
+    if (argc >= 3 && strcmp(argv[1], "--serve") == 0)
+        return lancer_serveur(argv[2]) ? 0 : 1;
+    if (argc >= 2 && strcmp(argv[1], "--replay") == 0)
+        return rejouer(argc >= 3 ? argv[2] : REJEU_FICHIER);
+    if (argc >= 2 && strcmp(argv[1], "--batch") == 0)
+        return lot(argc - 2, argv + 2);
     boucle_menu_avance();
     return 0;
 }
+
+int main(int argc, char **argv) {
+    // --trace <fichier>, --quiet, --aide et --cache-ko <n> se combinent avec les autres modes
+    for (;;) {
+        if (argc >= 3 && strcmp(argv[1], "--trace") == 0) {
+            if (!trace_ouvrir(argv[2])) {
+                fprintf(stderr, "Impossible d'ouvrir la trace %s\n", argv[2]);
+                return 1;
+            }
+            argv[2] = argv[0];
+            argc -= 2;
+            argv += 2;
+        } else if (argc >= 3 && strcmp(argv[1], "--cache-ko") == 0) {
+            ia_fixer_plafond_cache((size_t)strtoul(argv[2], NULL, 10) * 1024);
+            argv[2] = argv[0];
+            argc -= 2;
+            argv += 2;
+        } else if (argc >= 2 && strcmp(argv[1], "--aide") == 0) {
+            jeu_humain_fixer_aide(true);
+            argv[1] = argv[0];
+            argc -= 1;
+            argv += 1;
+        } else if (argc >= 2 && strcmp(argv[1], "--quiet") == 0) {
+            sortie_rendre_muette(true);
+            argv[1] = argv[0];
+            argc -= 1;
+            argv += 1;
+        } else {
+            break;
+        }
+    }
+    int code = lancer(argc, argv);
+    trace_fermer();
+    return code;
+}
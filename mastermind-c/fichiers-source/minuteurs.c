@@ -0,0 +1,128 @@
+#include <stdbool.h>
+#include "minuteurs.h"
+
+#define MASQUE (ROUE_CASES - 1)
+
+static bool arme(const Minuteur *m) { return m->suivant != NULL; }
+
+static void vider(Minuteur *tete) {
+    tete->suivant = tete->precedent = tete;
+}
+
+void roue_init(RoueMinuteurs *r, uint64_t maintenant_ms) {
+    for (int n=0;n<ROUE_NIVEAUX;n++)
+        for (int i=0;i<ROUE_CASES;i++) vider(&r->cases[n][i]);
+    r->courant = maintenant_ms / ROUE_PAS_MS;
+    r->nb = 0;
+}
+
+static void inserer(Minuteur *tete, Minuteur *m) {
+    m->suivant = tete;
+    m->precedent = tete->precedent;
+    tete->precedent->suivant = m;
+    tete->precedent = m;
+}
+
+static void detacher(Minuteur *m) {
+    m->precedent->suivant = m->suivant;
+    m->suivant->precedent = m->precedent;
+    m->suivant = m->precedent = NULL;
+}
+
+// Range m au niveau le plus bas dont la portée contient son échéance
+static void placer(RoueMinuteurs *r, Minuteur *m) {
+    uint64_t e = m->echeance;
+    if (e < r->courant) e = r->courant;
+    uint64_t delta = e - r->courant;
+    int n = 0;
+    while (n < ROUE_NIVEAUX - 1 && delta >= (1ULL << (ROUE_BITS * (n + 1)))) n++;
+    if (n == ROUE_NIVEAUX - 1) {
+        uint64_t max = (1ULL << (ROUE_BITS * ROUE_NIVEAUX)) - 1;
+        if (delta > max) e = r->courant + max;
+    }
+    inserer(&r->cases[n][(e >> (ROUE_BITS * n)) & MASQUE], m);
+}
+
+void roue_armer(RoueMinuteurs *r, Minuteur *m, uint64_t echeance_ms) {
+    if (arme(m)) roue_annuler(r, m);
+    // Arrondi au pas supérieur : jamais de déclenchement en avance
+    m->echeance = (echeance_ms + ROUE_PAS_MS - 1) / ROUE_PAS_MS;
+    placer(r, m);
+    r->nb++;
+}
+
+void roue_annuler(RoueMinuteurs *r, Minuteur *m) {
+    if (!arme(m)) return;
+    detacher(m);
+    r->nb--;
+}
+
+// Redescend une case du niveau n vers les niveaux inférieurs
+static void redescendre(RoueMinuteurs *r, int n, int i) {
+    Minuteur *tete = &r->cases[n][i];
+    while (tete->suivant != tete) {
+        Minuteur *m = tete->suivant;
+        detacher(m);
+        placer(r, m);
+    }
+}
+
+size_t roue_avancer(RoueMinuteurs *r, uint64_t maintenant_ms,
+                    RappelMinuteur rappel, void *ctx) {
+    uint64_t cible = maintenant_ms / ROUE_PAS_MS;
+    size_t declenches = 0;
+
+    while (r->courant <= cible) {
+        if (r->nb == 0) {           // roue vide : saut direct
+            r->courant = cible + 1;
+            break;
+        }
+        int i = (int)(r->courant & MASQUE);
+        for (int n=1; n<ROUE_NIVEAUX && i==0; n++) {
+            i = (int)((r->courant >> (ROUE_BITS * n)) & MASQUE);
+            redescendre(r, n, i);
+        }
+
+        // Le lot est d'abord détaché de la roue : les rappels peuvent
+        // réarmer (y compris dans cette case) sans perturber le parcours.
+        Minuteur lot;
+        Minuteur *tete = &r->cases[0][r->courant & MASQUE];
+        r->courant++;
+        if (tete->suivant == tete) continue;
+        lot.suivant = tete->suivant;
+        lot.precedent = tete->precedent;
+        lot.suivant->precedent = &lot;
+        lot.precedent->suivant = &lot;
+        vider(tete);
+
+        while (lot.suivant != &lot) {
+            Minuteur *m = lot.suivant;
+            detacher(m);
+            r->nb--;
+            declenches++;
+            rappel(m, ctx);
+        }
+    }
+    return declenches;
+}
+
+uint64_t roue_prochain_reveil(const RoueMinuteurs *r) {
+    if (r->nb == 0) return UINT64_MAX;
+    uint64_t meilleur = UINT64_MAX;
+    for (int n=0;n<ROUE_NIVEAUX;n++) {
+        int decalage = ROUE_BITS * n;
+        uint64_t base = r->courant >> decalage;
+        // Au niveau 0 la case courante compte ; au-delà elle a déjà été
+        // redescendue et ne sera revue qu'au tour suivant.
+        for (int k = (n == 0 ? 0 : 1); k <= ROUE_CASES; k++) {
+            if (n == 0 && k == ROUE_CASES) break;
+            const Minuteur *tete = &r->cases[n][(base + (uint64_t)k) & MASQUE];
+            if (tete->suivant == tete) continue;
+            uint64_t pas = (base + (uint64_t)k) << decalage;
+            if (pas < r->courant) pas = r->courant;
+            if (pas < meilleur) meilleur = pas;
+            break;
+        }
+    }
+    return meilleur == UINT64_MAX ? UINT64_MAX : meilleur * ROUE_PAS_MS;
+}
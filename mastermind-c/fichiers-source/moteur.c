@@ -0,0 +1,312 @@
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "moteur.h"
+#include "alea.h"
+#include "horloge.h"
+#include "couleurs.h"
+#include "feedback.h"
+#include "parse.h"
+#include "sauvegarde.h"
+
+typedef struct {
+    uint32_t duree_us;      // temps de la tentative (sature à ~71 min)
+    char code[CODE_LEN];
+    signed char noirs, blancs;
+} Coup;
+
+// L'historique est dimensionné selon max_tries (et non 64 coups fixes) :
+// la session vient du pool de la plus petite classe qui le contient.
+struct Session {
+    GameConfig cfg;
+    uint64_t graine;        // graine du secret, pour rejouer la partie
+    char secret[CODE_LEN];
+    uint8_t tries;
+    uint8_t etat;           // EtatPartie
+    bool expiree;           // tentative en cours abandonnée à l'échéance
+    uint8_t manquees;       // échéances consécutives sans proposition
+    uint8_t classe;
+    Minuteur echeance;      // échéance de la tentative (mode chronométré)
+    RoueMinuteurs *roue;    // roue où l'échéance est armée, sinon NULL
+    uint64_t etiquette;     // libre pour l'appelant
+    uint64_t debut_ns;      // début de la tentative en cours
+    Coup coups[];
+};
+
+static const int BORNES_CLASSES[SESSION_NB_CLASSES] = { 10, 15, 20, MAX_TRIES_MAX };
+static Pool pools[SESSION_NB_CLASSES];
+static pthread_once_t pools_init = PTHREAD_ONCE_INIT;
+static struct timespec debut_pools;
+
+static void initialiser_pools(void) {
+    for (int i=0;i<SESSION_NB_CLASSES;i++)
+        pool_init(&pools[i], sizeof(Session) + (size_t)BORNES_CLASSES[i] * sizeof(Coup));
+    clock_gettime(CLOCK_MONOTONIC, &debut_pools);
+}
+
+static Session *allouer_session(const GameConfig *cfg) {
+    pthread_once(&pools_init, initialiser_pools);
+    int c = 0;
+    while (BORNES_CLASSES[c] < cfg->max_tries) c++;
+    Session *s = pool_allouer(&pools[c]);
+    if (!s) return NULL;
+    s->cfg = *cfg;
+    s->tries = 0;
+    s->etat = PARTIE_EN_COURS;
+    s->expiree = false;
+    s->manquees = 0;
+    s->etiquette = 0;
+    s->classe = (uint8_t)c;
+    s->echeance.suivant = s->echeance.precedent = NULL;
+    s->roue = NULL;
+    s->debut_ns = horloge_ns();
+    return s;
+}
+
+static uint32_t duree_en_us(uint64_t ns) {
+    uint64_t us = ns / 1000u;
+    return us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+}
+
+static bool config_valide(const GameConfig *cfg) {
+    return cfg->color_count >= MIN_COLORS && cfg->color_count <= MAX_COLORS
+        && cfg->max_tries >= MAX_TRIES_MIN && cfg->max_tries <= MAX_TRIES_MAX
+        && (cfg->allow_repetition || cfg->color_count >= CODE_LEN)
+        && (!cfg->timed_mode || cfg->time_per_try_sec >= 1);
+}
+
+Session *session_creer(const GameConfig *cfg, uint64_t graine) {
+    if (!config_valide(cfg)) return NULL;
+    Session *s = allouer_session(cfg);
+    if (!s) return NULL;
+    Alea a;
+    alea_init(&a, graine);
+    s->graine = graine;
+    generer_secret(s->secret, cfg->color_count, cfg->allow_repetition, &a);
+    return s;
+}
+
+// Un état venu d'un fichier n'est pas cru sur parole : secret et
+// propositions doivent respecter la configuration, chaque feedback est
+// recalculé, et seul le dernier coup peut avoir trouvé le code.
+static bool etat_coherent(const GameState *gs) {
+    const GameConfig *cfg = &gs->cfg;
+    if (!config_valide(cfg) || gs->tries < 0 || gs->tries > cfg->max_tries
+        || !code_valide(gs->secret, cfg->color_count, cfg->allow_repetition))
+        return false;
+    for (int i=0;i<gs->tries;i++) {
+        int n, b;
+        if (!code_valide(gs->guesses[i], cfg->color_count, cfg->allow_repetition))
+            return false;
+        calculer_feedback(gs->secret, gs->guesses[i], &n, &b);
+        if (n != gs->blacks[i] || b != gs->whites[i]) return false;
+        if (n == CODE_LEN && i != gs->tries - 1) return false;
+    }
+    return true;
+}
+
+Session *session_depuis_etat(const GameState *gs) {
+    if (!etat_coherent(gs)) return NULL;
+    Session *s = allouer_session(&gs->cfg);
+    if (!s) return NULL;
+    s->graine = 0;          // secret fourni, pas de graine connue
+    memcpy(s->secret, gs->secret, CODE_LEN);
+    s->tries = (uint8_t)gs->tries;
+    for (int i=0;i<gs->tries;i++) {
+        memcpy(s->coups[i].code, gs->guesses[i], CODE_LEN);
+        s->coups[i].noirs = (signed char)gs->blacks[i];
+        s->coups[i].blancs = (signed char)gs->whites[i];
+        s->coups[i].duree_us = duree_en_us(gs->durees_ns[i]);
+    }
+    if (gs->tries > 0 && gs->blacks[gs->tries-1] == CODE_LEN)
+        s->etat = PARTIE_GAGNEE;
+    else if (gs->tries == gs->cfg.max_tries)
+        s->etat = PARTIE_PERDUE;
+    return s;
+}
+
+static void annuler_echeance(Session *s) {
+    if (!s->roue) return;
+    roue_annuler(s->roue, &s->echeance);
+    s->roue = NULL;
+}
+
+void session_detruire(Session *s) {
+    if (!s) return;
+    annuler_echeance(s);
+    pool_liberer(&pools[s->classe], s);
+}
+
+static void reprogrammer(Session *s, uint64_t maintenant_ms) {
+    roue_armer(s->roue, &s->echeance,
+               maintenant_ms + (uint64_t)s->cfg.time_per_try_sec * 1000u);
+}
+
+void session_armer_echeance(Session *s, RoueMinuteurs *r, uint64_t maintenant_ms) {
+    if (!s->cfg.timed_mode || s->etat != PARTIE_EN_COURS) return;
+    annuler_echeance(s);
+    s->roue = r;
+    reprogrammer(s, maintenant_ms);
+}
+
+typedef struct {
+    uint64_t maintenant_ms;
+    RappelPartieFinie fin;
+    void *ctx;
+} AvanceeEcheances;
+
+// Rappel de la roue : la tentative est abandonnée, la suivante commence,
+// sauf si la partie vient d'être perdue faute de joueur
+static void echeance_atteinte(Minuteur *m, void *ctx) {
+    const AvanceeEcheances *a = ctx;
+    Session *s = (Session *)((char *)m - offsetof(Session, echeance));
+    session_expirer(s);
+    if (s->etat == PARTIE_EN_COURS) {
+        reprogrammer(s, a->maintenant_ms);
+        return;
+    }
+    if (a->fin) a->fin(s, a->ctx);
+}
+
+size_t sessions_avancer_echeances(RoueMinuteurs *r, uint64_t maintenant_ms,
+                                  RappelPartieFinie fin, void *ctx) {
+    AvanceeEcheances a = { maintenant_ms, fin, ctx };
+    return roue_avancer(r, maintenant_ms, echeance_atteinte, &a);
+}
+
+ResultatCoup session_proposer(Session *s, const char code[CODE_LEN],
+                              int *noirs, int *blancs) {
+    if (s->etat != PARTIE_EN_COURS) return COUP_TERMINE;
+    s->manquees = 0;
+    if (s->expiree) {
+        s->expiree = false;
+        return COUP_HORS_DELAI;
+    }
+    const GameConfig *cfg = &s->cfg;
+    if (!code_valide(code, cfg->color_count, cfg->allow_repetition)) return COUP_INVALIDE;
+
+    int n=0, b=0;
+    calculer_feedback(s->secret, code, &n, &b);
+
+    uint64_t t = horloge_ns();
+    Coup *c = &s->coups[s->tries++];
+    c->duree_us = duree_en_us(t - s->debut_ns);
+    s->debut_ns = t;
+    memcpy(c->code, code, CODE_LEN);
+    c->noirs = (signed char)n;
+    c->blancs = (signed char)b;
+    if (noirs) *noirs = n;
+    if (blancs) *blancs = b;
+
+    if (n == CODE_LEN) {
+        s->etat = PARTIE_GAGNEE;
+        annuler_echeance(s);
+        return COUP_GAGNE;
+    }
+    if (s->tries >= cfg->max_tries) {
+        s->etat = PARTIE_PERDUE;
+        annuler_echeance(s);
+        return COUP_PERDU;
+    }
+    if (s->roue) reprogrammer(s, horloge_ms());
+    return COUP_OK;
+}
+
+ResultatCoup session_proposer_texte(Session *s, const char *ligne,
+                                    int *noirs, int *blancs) {
+    if (s->etat != PARTIE_EN_COURS) return COUP_TERMINE;
+    char code[CODE_LEN];
+    if (!parser_proposition(ligne, code, s->cfg.color_count,
+                            s->cfg.allow_repetition))
+        return COUP_INVALIDE;
+    return session_proposer(s, code, noirs, blancs);
+}
+
+void session_expirer(Session *s) {
+    if (s->etat != PARTIE_EN_COURS) return;
+    s->expiree = true;
+    if (++s->manquees >= SESSION_ECHEANCES_MAX) {
+        s->etat = PARTIE_PERDUE;
+        annuler_echeance(s);
+    }
+}
+
+uint64_t session_duree_coup_ns(const Session *s, int i) {
+    return (uint64_t)s->coups[i].duree_us * 1000u;
+}
+
+// Somme des tentatives jouées, plus la tentative en cours s'il y en a une
+uint64_t session_duree_ns(const Session *s) {
+    uint64_t total = 0;
+    for (int i=0;i<s->tries;i++) total += session_duree_coup_ns(s, i);
+    if (s->etat == PARTIE_EN_COURS) total += horloge_ns() - s->debut_ns;
+    return total;
+}
+
+EtatPartie session_etat(const Session *s) { return (EtatPartie)s->etat; }
+const GameConfig *session_config(const Session *s) { return &s->cfg; }
+int session_tentatives(const Session *s) { return s->tries; }
+uint64_t session_graine(const Session *s) { return s->graine; }
+uint64_t session_etiquette(const Session *s) { return s->etiquette; }
+void session_fixer_etiquette(Session *s, uint64_t etiquette) { s->etiquette = etiquette; }
+
+void session_coup(const Session *s, int i, char code[CODE_LEN],
+                  int *noirs, int *blancs) {
+    memcpy(code, s->coups[i].code, CODE_LEN);
+    if (noirs) *noirs = s->coups[i].noirs;
+    if (blancs) *blancs = s->coups[i].blancs;
+}
+
+void session_secret(const Session *s, char code[CODE_LEN]) {
+    memcpy(code, s->secret, CODE_LEN);
+}
+
+void session_vers_etat(const Session *s, GameState *gs) {
+    memset(gs, 0, sizeof(*gs));
+    gs->cfg = s->cfg;
+    memcpy(gs->secret, s->secret, CODE_LEN);
+    gs->tries = s->tries;
+    for (int i=0;i<s->tries;i++) {
+        memcpy(gs->guesses[i], s->coups[i].code, CODE_LEN);
+        gs->blacks[i] = s->coups[i].noirs;
+        gs->whites[i] = s->coups[i].blancs;
+        gs->durees_ns[i] = session_duree_coup_ns(s, i);
+    }
+    gs->duree_ns = session_duree_ns(s);
+    gs->in_progress = (s->etat == PARTIE_EN_COURS);
+}
+
+size_t session_serialiser(const Session *s, char *buf, size_t taille) {
+    GameState gs;
+    session_vers_etat(s, &gs);
+    return formater_partie(&gs, buf, taille);
+}
+
+Session *session_deserialiser(const char *texte) {
+    GameState gs;
+    if (!analyser_partie(&gs, texte)) return NULL;
+    return session_depuis_etat(&gs);
+}
+
+void session_memoire(MemoireSessions *out) {
+    pthread_once(&pools_init, initialiser_pools);
+    memset(out, 0, sizeof(*out));
+    size_t octets = 0;
+    unsigned long allocations = 0;
+    for (int i=0;i<SESSION_NB_CLASSES;i++) {
+        out->classes[i].max_tries = BORNES_CLASSES[i];
+        pool_statistiques(&pools[i], &out->classes[i].pool);
+        out->vivantes += out->classes[i].pool.vivants;
+        octets += out->classes[i].pool.octets_reserves;
+        allocations += out->classes[i].pool.allocations;
+    }
+    if (out->vivantes > 0) out->octets_par_session = octets / out->vivantes;
+
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    double ecoule = (double)(t.tv_sec - debut_pools.tv_sec)
+                  + (double)(t.tv_nsec - debut_pools.tv_nsec) / 1e9;
+    if (ecoule > 0.0) out->allocations_par_sec = (double)allocations / ecoule;
+}
@@ -1,38 +1,134 @@
-#include <ctype.h>
 #include "parse.h"
 #include "couleurs.h"
 
+/* Classe de chaque octet : indice de couleur (0..5, dans l'ordre de
+   GLOBAL_COLOR_SET, majuscule ou minuscule), lettre hors palette (X) ou
+   séparateur ignoré (S, tout ce qui n'est pas une lettre ASCII). */
+#define S 0xFF
+#define X 0xFE
+static const uint8_t CLASSE_OCTET[256] = {
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, X, 2, X, X, X, X, 1, X, X, X, X, X, X, X, 4,     // @ A..O
+    5, X, 0, X, X, X, X, X, X, 3, X, S, S, S, S, S,     // P..Z
+    S, X, 2, X, X, X, X, 1, X, X, X, X, X, X, X, 4,     // ` a..o
+    5, X, 0, X, X, X, X, X, X, 3, X, S, S, S, S, S,     // p..z
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+    S, S, S, S, S, S, S, S, S, S, S, S, S, S, S, S,
+};
+#undef S
+#undef X
+#define SEPARATEUR 0xFF
+
 bool caractere_couleur_valide(char c, int color_count) {
-    c = (char)toupper((unsigned char)c);
-    for (int i=0;i<color_count;i++) {
-        if (GLOBAL_COLOR_SET[i]==c) return true;
-    }
-    return false;
+    return CLASSE_OCTET[(unsigned char)c] < color_count;
 }
 
 bool sans_repetition(const char code[], int len) {
+    uint64_t vus[4] = {0};
     for (int i=0;i<len;i++) {
-        for (int j=i+1;j<len;j++) {
-            if (code[i]==code[j]) return false;
-        }
+        unsigned char c = (unsigned char)code[i];
+        uint64_t bit = 1ULL << (c & 63);
+        if (vus[c >> 6] & bit) return false;
+        vus[c >> 6] |= bit;
     }
     return true;
 }
 
+bool code_valide(const char code[CODE_LEN], int color_count, bool allow_repetition) {
+    unsigned vus = 0, doublons = 0;
+    for (int i=0;i<CODE_LEN;i++) {
+        unsigned k = CLASSE_OCTET[(unsigned char)code[i]];
+        // Seules les majuscules sont des codes valides
+        if (k >= (unsigned)color_count || code[i] != GLOBAL_COLOR_SET[k]) return false;
+        doublons |= vus & (1u << k);
+        vus |= 1u << k;
+    }
+    return allow_repetition || !doublons;
+}
+
+bool parser_compact(const char *texte, size_t n, int color_count,
+                    bool allow_repetition, CodeCompact *out) {
+    unsigned count = 0, vus = 0, doublons = 0;
+    CodeCompact v = 0;
+    for (size_t i=0;i<n;i++) {
+        unsigned k = CLASSE_OCTET[(unsigned char)texte[i]];
+        if (k == SEPARATEUR) continue;
+        if (k >= (unsigned)color_count || count == CODE_LEN) return false;
+        doublons |= vus & (1u << k);
+        vus |= 1u << k;
+        v |= (CodeCompact)(k << (3 * count++));
+    }
+    if (count != CODE_LEN || (!allow_repetition && doublons)) return false;
+    *out = v;
+    return true;
+}
+
+size_t parser_propositions(const char *buf, size_t n, int color_count,
+                           bool allow_repetition, CodeCompact *codes,
+                           size_t max, size_t *consommes) {
+    size_t nb = 0, debut = 0;
+    unsigned count = 0, vus = 0, doublons = 0;
+    bool refusee = false;
+    CodeCompact v = 0;
+
+    // Une seule passe : l'état de la ligne en cours est remis à zéro à chaque '\n'
+    for (size_t i=0;i<n && nb<max;i++) {
+        unsigned char c = (unsigned char)buf[i];
+        if (c == '\n') {
+            bool ok = !refusee && count == CODE_LEN && (allow_repetition || !doublons);
+            codes[nb++] = ok ? v : CODE_COMPACT_INVALIDE;
+            count = vus = doublons = 0;
+            refusee = false;
+            v = 0;
+            debut = i + 1;
+            continue;
+        }
+        unsigned k = CLASSE_OCTET[c];
+        if (k == SEPARATEUR || refusee) continue;
+        if (k >= (unsigned)color_count || count == CODE_LEN) {
+            refusee = true;
+            continue;
+        }
+        doublons |= vus & (1u << k);
+        vus |= 1u << k;
+        v |= (CodeCompact)(k << (3 * count++));
+    }
+    if (consommes) *consommes = debut;
+    return nb;
+}
+
 bool parser_proposition(const char *ligne, char out_code[CODE_LEN],
                         int color_count, bool allow_repetition) {
-    int count=0;
-    for (const char *p=ligne; *p; ++p) {
-        char c=*p;
-        if (isalpha((unsigned char)c)) {
-            c=(char)toupper((unsigned char)c);
-            if (!caractere_couleur_valide(c, color_count)) return false;
-            if (count < CODE_LEN) {
-                out_code[count++] = c;
-            } else return false;
-        }
+    size_t n = 0;
+    while (ligne[n]) n++;
+    CodeCompact v;
+    if (!parser_compact(ligne, n, color_count, allow_repetition, &v)) return false;
+    return code_decompacter(v, out_code);
+}
+
+CodeCompact code_compacter(const char code[CODE_LEN]) {
+    CodeCompact v = 0;
+    for (int i=0;i<CODE_LEN;i++) {
+        unsigned k = CLASSE_OCTET[(unsigned char)code[i]];
+        v |= (CodeCompact)((k & 7) << (3 * i));
+    }
+    return v;
+}
+
+bool code_decompacter(CodeCompact v, char code[CODE_LEN]) {
+    for (int i=0;i<CODE_LEN;i++) {
+        unsigned k = (v >> (3 * i)) & 7;
+        if (k >= MAX_COLORS) return false;
+        code[i] = GLOBAL_COLOR_SET[k];
     }
-    if (count != CODE_LEN) return false;
-    if (!allow_repetition && !sans_repetition(out_code, CODE_LEN)) return false;
     return true;
 }
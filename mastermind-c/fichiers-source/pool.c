@@ -0,0 +1,76 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pool.h"
+
+struct BlocLibre {
+    BlocLibre *suivant;
+};
+
+void pool_init(Pool *p, size_t taille_objet) {
+    memset(p, 0, sizeof(*p));
+    if (taille_objet < sizeof(BlocLibre)) taille_objet = sizeof(BlocLibre);
+    p->taille = (taille_objet + POOL_ALIGNEMENT - 1) & ~(size_t)(POOL_ALIGNEMENT - 1);
+    pthread_mutex_init(&p->verrou, NULL);
+}
+
+static bool nouveau_slab(Pool *p) {
+    if (p->nb_slabs == p->cap_slabs) {
+        size_t cap = p->cap_slabs ? p->cap_slabs * 2 : 8;
+        void **t = realloc(p->slabs, cap * sizeof(void *));
+        if (!t) return false;
+        p->slabs = t;
+        p->cap_slabs = cap;
+    }
+    char *slab = aligned_alloc(POOL_ALIGNEMENT, POOL_TAILLE_SLAB);
+    if (!slab) return false;
+    p->slabs[p->nb_slabs++] = slab;
+    p->courant = slab;
+    p->restant = POOL_TAILLE_SLAB;
+    return true;
+}
+
+void *pool_allouer(Pool *p) {
+    pthread_mutex_lock(&p->verrou);
+    void *obj = NULL;
+    if (p->libres) {
+        obj = p->libres;
+        p->libres = p->libres->suivant;
+    } else if (p->restant >= p->taille || nouveau_slab(p)) {
+        obj = p->courant;
+        p->courant += p->taille;
+        p->restant -= p->taille;
+    }
+    if (obj) {
+        p->vivants++;
+        p->allocations++;
+    }
+    pthread_mutex_unlock(&p->verrou);
+    return obj;
+}
+
+void pool_liberer(Pool *p, void *obj) {
+    if (!obj) return;
+    BlocLibre *b = obj;
+    pthread_mutex_lock(&p->verrou);
+    b->suivant = p->libres;
+    p->libres = b;
+    p->vivants--;
+    pthread_mutex_unlock(&p->verrou);
+}
+
+void pool_statistiques(Pool *p, PoolStats *out) {
+    pthread_mutex_lock(&p->verrou);
+    out->taille = p->taille;
+    out->vivants = p->vivants;
+    out->allocations = p->allocations;
+    out->octets_reserves = p->nb_slabs * (size_t)POOL_TAILLE_SLAB;
+    pthread_mutex_unlock(&p->verrou);
+}
+
+void pool_detruire(Pool *p) {
+    for (size_t i=0;i<p->nb_slabs;i++) free(p->slabs[i]);
+    free(p->slabs);
+    pthread_mutex_destroy(&p->verrou);
+    memset(p, 0, sizeof(*p));
+}
@@ -0,0 +1,75 @@
+#include "rang.h"
+
+/* ============================================================
+   Rang dense des codes (base n ou code de Lehmer)
+   ============================================================ */
+
+// Arrangements de k couleurs parmi n : n (n-1) ... (n-k+1)
+static int arrangements(int n, int k)
+{
+    int a = 1;
+    for (int i = 0; i < k; i++) a *= n - i;
+    return a;
+}
+
+int nombre_codes(int color_count, bool allow_repetition)
+{
+    if (color_count < MIN_COLORS || color_count > MAX_COLORS) return 0;
+    if (!allow_repetition) return arrangements(color_count, CODE_LEN);
+    int n = 1;
+    for (int i = 0; i < CODE_LEN; i++) n *= color_count;
+    return n;
+}
+
+int code_rang(CodeCompact v, int color_count, bool allow_repetition)
+{
+    if (color_count < MIN_COLORS || color_count > MAX_COLORS) return -1;
+    int rang = 0;
+    unsigned utilisees = 0;     // une couleur par bit
+    for (int i = 0; i < CODE_LEN; i++) {
+        unsigned k = (v >> (3 * i)) & 7;
+        if (k >= (unsigned)color_count) return -1;
+        if (allow_repetition) {
+            rang = rang * color_count + (int)k;
+            continue;
+        }
+        if (utilisees & (1u << k)) return -1;
+        // Chiffre de Lehmer : couleurs libres plus petites que k
+        int chiffre = (int)k - __builtin_popcount(utilisees & ((1u << k) - 1));
+        rang += chiffre * arrangements(color_count - 1 - i, CODE_LEN - 1 - i);
+        utilisees |= 1u << k;
+    }
+    return rang;
+}
+
+bool code_depuis_rang(int rang, int color_count, bool allow_repetition,
+                      CodeCompact *out)
+{
+    if (rang < 0 || rang >= nombre_codes(color_count, allow_repetition))
+        return false;
+    CodeCompact v = 0;
+    if (allow_repetition) {
+        for (int i = CODE_LEN - 1; i >= 0; i--) {
+            v |= (CodeCompact)((rang % color_count) << (3 * i));
+            rang /= color_count;
+        }
+        *out = v;
+        return true;
+    }
+    unsigned utilisees = 0;
+    for (int i = 0; i < CODE_LEN; i++) {
+        int poids = arrangements(color_count - 1 - i, CODE_LEN - 1 - i);
+        int chiffre = rang / poids;
+        rang %= poids;
+        // chiffre-ième couleur encore libre
+        int k = 0;
+        for (;; k++) {
+            if (utilisees & (1u << k)) continue;
+            if (chiffre-- == 0) break;
+        }
+        v |= (CodeCompact)(k << (3 * i));
+        utilisees |= 1u << k;
+    }
+    *out = v;
+    return true;
+}
@@ -0,0 +1,207 @@
+#include <string.h>
+#include <time.h>
+#include "rejeu.h"
+#include "parse.h"
+#include "solveur.h"
+
+/* Format binaire (petit-boutiste), enregistrements ajoutés bout à bout :
+     'M' 'R' mode:u8 options:u8 couleurs:u8 max_tries:u8 sec:u16
+     graine:u64 secret:u16 deja_joues:u8 nb_coups:u8
+     nb_coups x (code:u16 feedback:u8 instant_ms:u32)
+   Un code tient sur 12 bits (3 bits par couleur), le feedback vaut
+   noirs*5+blancs. options : bit0 répétitions, bit1 chrono, bit2 graine. */
+
+#define TAILLE_ENTETE 20
+#define TAILLE_COUP 7
+
+static void ecrire_u16(unsigned char *p, uint16_t v) { p[0]=(unsigned char)v; p[1]=(unsigned char)(v>>8); }
+static void ecrire_u32(unsigned char *p, uint32_t v) { for (int i=0;i<4;i++) p[i]=(unsigned char)(v>>(8*i)); }
+static void ecrire_u64(unsigned char *p, uint64_t v) { for (int i=0;i<8;i++) p[i]=(unsigned char)(v>>(8*i)); }
+static uint16_t lire_u16(const unsigned char *p) { return (uint16_t)(p[0] | (p[1]<<8)); }
+static uint32_t lire_u32(const unsigned char *p) {
+    uint32_t v=0; for (int i=0;i<4;i++) v |= (uint32_t)p[i]<<(8*i); return v;
+}
+static uint64_t lire_u64(const unsigned char *p) {
+    uint64_t v=0; for (int i=0;i<8;i++) v |= (uint64_t)p[i]<<(8*i); return v;
+}
+
+static uint32_t ms_depuis(const struct timespec *debut) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    long long ms = (long long)(t.tv_sec - debut->tv_sec) * 1000
+                 + (t.tv_nsec - debut->tv_nsec) / 1000000;
+    return ms < 0 ? 0 : (uint32_t)ms;
+}
+
+/* ============================================================
+   Enregistrement
+   ============================================================ */
+
+void rejeu_debut(EnregistrementPartie *e, const Session *s, ModeRejeu mode) {
+    memset(e, 0, sizeof(*e));
+    e->mode = mode;
+    e->cfg = *session_config(s);
+    e->graine = session_graine(s);
+    e->graine_valide = session_graine(s) != 0;
+    session_secret(s, e->secret);
+    // Une partie reprise garde ses coups antérieurs (instant 0)
+    for (int i=0;i<session_tentatives(s);i++) {
+        int n, b;
+        session_coup(s, i, e->coups[i], &n, &b);
+        e->noirs[i] = (uint8_t)n;
+        e->blancs[i] = (uint8_t)b;
+    }
+    e->nb_coups = e->deja_joues = session_tentatives(s);
+    clock_gettime(CLOCK_MONOTONIC, &e->debut);
+}
+
+void rejeu_noter_coup(EnregistrementPartie *e, const Session *s) {
+    int i = session_tentatives(s) - 1;
+    if (i < 0 || i >= MAX_TRIES_MAX || i != e->nb_coups) return;
+    int n, b;
+    session_coup(s, i, e->coups[i], &n, &b);
+    e->noirs[i] = (uint8_t)n;
+    e->blancs[i] = (uint8_t)b;
+    e->instants_ms[i] = ms_depuis(&e->debut);
+    e->nb_coups++;
+}
+
+bool rejeu_ecrire(const EnregistrementPartie *e, const char *chemin) {
+    unsigned char buf[TAILLE_ENTETE + MAX_TRIES_MAX * TAILLE_COUP];
+    unsigned char *p = buf;
+    p[0] = 'M'; p[1] = 'R';
+    p[2] = (unsigned char)e->mode;
+    p[3] = (unsigned char)((e->cfg.allow_repetition ? 1 : 0)
+                         | (e->cfg.timed_mode ? 2 : 0)
+                         | (e->graine_valide ? 4 : 0));
+    p[4] = (unsigned char)e->cfg.color_count;
+    p[5] = (unsigned char)e->cfg.max_tries;
+    ecrire_u16(p + 6, (uint16_t)e->cfg.time_per_try_sec);
+    ecrire_u64(p + 8, e->graine);
+    ecrire_u16(p + 16, code_compacter(e->secret));
+    p[18] = (unsigned char)e->deja_joues;
+    p[19] = (unsigned char)e->nb_coups;
+    p += TAILLE_ENTETE;
+    for (int i=0;i<e->nb_coups;i++) {
+        ecrire_u16(p, code_compacter(e->coups[i]));
+        p[2] = (unsigned char)(e->noirs[i] * 5 + e->blancs[i]);
+        ecrire_u32(p + 3, e->instants_ms[i]);
+        p += TAILLE_COUP;
+    }
+
+    FILE *f = fopen(chemin, "ab");
+    if (!f) return false;
+    size_t n = (size_t)(p - buf);
+    bool ok = fwrite(buf, 1, n, f) == n;
+    return fclose(f) == 0 && ok;
+}
+
+bool rejeu_lire(FILE *f, EnregistrementPartie *e) {
+    unsigned char buf[TAILLE_ENTETE + MAX_TRIES_MAX * TAILLE_COUP];
+    if (fread(buf, 1, TAILLE_ENTETE, f) != TAILLE_ENTETE) return false;
+    if (buf[0] != 'M' || buf[1] != 'R') return false;
+    memset(e, 0, sizeof(*e));
+    e->mode = buf[2] == REJEU_IA ? REJEU_IA : REJEU_HUMAIN;
+    e->cfg.allow_repetition = (buf[3] & 1) != 0;
+    e->cfg.timed_mode = (buf[3] & 2) != 0;
+    e->graine_valide = (buf[3] & 4) != 0;
+    e->cfg.color_count = buf[4];
+    e->cfg.max_tries = buf[5];
+    e->cfg.time_per_try_sec = lire_u16(buf + 6);
+    e->graine = lire_u64(buf + 8);
+    if (!code_decompacter(lire_u16(buf + 16), e->secret)) return false;
+    e->deja_joues = buf[18];
+    e->nb_coups = buf[19];
+    if (e->nb_coups > MAX_TRIES_MAX || e->deja_joues > e->nb_coups) return false;
+
+    size_t n = (size_t)e->nb_coups * TAILLE_COUP;
+    if (fread(buf, 1, n, f) != n) return false;
+    const unsigned char *p = buf;
+    for (int i=0;i<e->nb_coups;i++) {
+        if (!code_decompacter(lire_u16(p), e->coups[i])) return false;
+        e->noirs[i] = p[2] / 5;
+        e->blancs[i] = p[2] % 5;
+        e->instants_ms[i] = lire_u32(p + 3);
+        p += TAILLE_COUP;
+    }
+    return true;
+}
+
+/* ============================================================
+   Rejeu : réexécution dans le moteur, sans attente ni affichage
+   ============================================================ */
+
+static Session *recreer_session(const EnregistrementPartie *e, unsigned long *divergences) {
+    if (e->graine_valide) {
+        Session *s = session_creer(&e->cfg, e->graine);
+        if (!s) return NULL;
+        char secret[CODE_LEN];
+        session_secret(s, secret);
+        if (memcmp(secret, e->secret, CODE_LEN) != 0) (*divergences)++;
+        return s;
+    }
+    GameState gs;
+    memset(&gs, 0, sizeof(gs));
+    gs.cfg = e->cfg;
+    memcpy(gs.secret, e->secret, CODE_LEN);
+    return session_depuis_etat(&gs);
+}
+
+static void rejouer_partie(const EnregistrementPartie *e, RapportRejeu *r) {
+    Session *s = recreer_session(e, &r->divergences);
+    if (!s) { r->divergences++; return; }
+
+    // En mode IA on rejoue aussi le solveur et on vérifie ses choix ; une
+    // partie reprise par l'IA part des candidats de son historique
+    Solveur *sv = e->mode == REJEU_IA ? solveur_creer(&e->cfg) : NULL;
+    // Mêmes choix qu'en recalcul, et le premier coup vient du cache
+    if (sv) solveur_choisir_mode(sv, SOLVEUR_INCREMENTAL);
+    if (sv && e->deja_joues > 0) {
+        int noirs[MAX_TRIES_MAX], blancs[MAX_TRIES_MAX];
+        for (int i=0;i<e->deja_joues;i++) {
+            noirs[i] = e->noirs[i];
+            blancs[i] = e->blancs[i];
+        }
+        solveur_appliquer_historique(sv, e->coups, noirs, blancs, e->deja_joues);
+    }
+
+    for (int i=0;i<e->nb_coups;i++) {
+        if (sv && i >= e->deja_joues) {
+            char choix[CODE_LEN];
+            solveur_proposer(sv, choix);
+            if (memcmp(choix, e->coups[i], CODE_LEN) != 0) r->divergences++;
+        }
+        int n, b;
+        ResultatCoup rc = session_proposer(s, e->coups[i], &n, &b);
+        r->coups++;
+        if ((rc != COUP_OK && rc != COUP_GAGNE && rc != COUP_PERDU)
+            || n != e->noirs[i] || b != e->blancs[i]) {
+            r->divergences++;
+            break;
+        }
+        if (sv && i >= e->deja_joues) solveur_filtrer(sv, e->coups[i], n, b);
+    }
+    r->parties++;
+    solveur_detruire(sv);
+    session_detruire(s);
+}
+
+bool rejouer_fichier(const char *chemin, RapportRejeu *r) {
+    memset(r, 0, sizeof(*r));
+    FILE *f = fopen(chemin, "rb");
+    if (!f) return false;
+
+    struct timespec t0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    EnregistrementPartie e;
+    while (rejeu_lire(f, &e))
+        rejouer_partie(&e, r);
+    bool complet = feof(f) != 0;
+    fclose(f);
+
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    r->duree_sec = (double)(t1.tv_sec - t0.tv_sec)
+                 + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+    return complet;
+}
@@ -1,55 +1,98 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "sauvegarde.h"
 
-bool sauvegarder_partie(const GameState *gs, const char *chemin) {
-    FILE *f = fopen(chemin, "w");
-    if (!f) return false;
-    fprintf(f, "color_count=%d\n", gs->cfg.color_count);
-    fprintf(f, "max_tries=%d\n", gs->cfg.max_tries);
-    fprintf(f, "allow_repetition=%d\n", gs->cfg.allow_repetition?1:0);
-    fprintf(f, "timed_mode=%d\n", gs->cfg.timed_mode?1:0);
-    fprintf(f, "time_per_try_sec=%d\n", gs->cfg.time_per_try_sec);
-    fprintf(f, "tries=%d\n", gs->tries);
-    fprintf(f, "secret=%c%c%c%c\n", gs->secret[0], gs->secret[1], gs->secret[2], gs->secret[3]);
+// Ajoute au tampon sans dépasser, en comptant la longueur totale voulue
+#define AJOUTER(...) do { \
+        int n_ = snprintf(buf + (pos < taille ? pos : taille), \
+                          pos < taille ? taille - pos : 0, __VA_ARGS__); \
+        if (n_ > 0) pos += (size_t)n_; \
+    } while (0)
+
+size_t formater_partie(const GameState *gs, char *buf, size_t taille) {
+    size_t pos = 0;
+    AJOUTER("color_count=%d\n", gs->cfg.color_count);
+    AJOUTER("max_tries=%d\n", gs->cfg.max_tries);
+    AJOUTER("allow_repetition=%d\n", gs->cfg.allow_repetition?1:0);
+    AJOUTER("timed_mode=%d\n", gs->cfg.timed_mode?1:0);
+    AJOUTER("time_per_try_sec=%d\n", gs->cfg.time_per_try_sec);
+    AJOUTER("tries=%d\n", gs->tries);
+    AJOUTER("duration_ns=%llu\n", (unsigned long long)gs->duree_ns);
+    AJOUTER("secret=%c%c%c%c\n", gs->secret[0], gs->secret[1], gs->secret[2], gs->secret[3]);
     for (int i=0;i<gs->tries;i++) {
-        fprintf(f, "guess%d=%c%c%c%c black=%d white=%d\n",
+        AJOUTER("guess%d=%c%c%c%c black=%d white=%d ns=%llu\n",
                 i+1, gs->guesses[i][0], gs->guesses[i][1],
                 gs->guesses[i][2], gs->guesses[i][3],
-                gs->blacks[i], gs->whites[i]);
+                gs->blacks[i], gs->whites[i],
+                (unsigned long long)gs->durees_ns[i]);
     }
-    fclose(f);
-    return true;
+    return pos;
 }
 
-bool charger_partie(GameState *gs, const char *chemin) {
-    FILE *f = fopen(chemin, "r");
-    if (!f) return false;
+static void analyser_ligne(GameState *gs, const char *line) {
+    if (sscanf(line, "color_count=%d", &gs->cfg.color_count)==1) return;
+    if (sscanf(line, "max_tries=%d", &gs->cfg.max_tries)==1) return;
+    int b;
+    if (sscanf(line, "allow_repetition=%d", &b)==1) { gs->cfg.allow_repetition=(b!=0); return; }
+    if (sscanf(line, "timed_mode=%d", &b)==1) { gs->cfg.timed_mode=(b!=0); return; }
+    if (sscanf(line, "time_per_try_sec=%d", &gs->cfg.time_per_try_sec)==1) return;
+    if (sscanf(line, "tries=%d", &gs->tries)==1) return;
+    unsigned long long ns = 0;
+    if (sscanf(line, "duration_ns=%llu", &ns)==1) { gs->duree_ns = ns; return; }
+    if (sscanf(line, "secret=%c%c%c%c",
+               &gs->secret[0], &gs->secret[1],
+               &gs->secret[2], &gs->secret[3])==4) return;
+
+    // ns= est absent des sauvegardes plus anciennes
+    int idx, black, white; char g0,g1,g2,g3;
+    if (sscanf(line, "guess%d=%c%c%c%c black=%d white=%d ns=%llu",
+               &idx, &g0,&g1,&g2,&g3, &black,&white, &ns)>=7
+        && idx >= 1 && idx <= 64) {
+        int i=idx-1;
+        gs->guesses[i][0]=g0; gs->guesses[i][1]=g1;
+        gs->guesses[i][2]=g2; gs->guesses[i][3]=g3;
+        gs->blacks[i]=black; gs->whites[i]=white;
+        gs->durees_ns[i]=ns;
+    }
+}
+
+bool analyser_partie(GameState *gs, const char *texte) {
     memset(gs, 0, sizeof(*gs));
     gs->in_progress = true;
 
     char line[256];
-    while (fgets(line, sizeof(line), f)) {
-        if (sscanf(line, "color_count=%d", &gs->cfg.color_count)==1) continue;
-        if (sscanf(line, "max_tries=%d", &gs->cfg.max_tries)==1) continue;
-        int b;
-        if (sscanf(line, "allow_repetition=%d", &b)==1) { gs->cfg.allow_repetition=(b!=0); continue; }
-        if (sscanf(line, "timed_mode=%d", &b)==1) { gs->cfg.timed_mode=(b!=0); continue; }
-        if (sscanf(line, "time_per_try_sec=%d", &gs->cfg.time_per_try_sec)==1) continue;
-        if (sscanf(line, "tries=%d", &gs->tries)==1) continue;
-        if (sscanf(line, "secret=%c%c%c%c",
-                   &gs->secret[0], &gs->secret[1],
-                   &gs->secret[2], &gs->secret[3])==4) continue;
-
-        int idx, black, white; char g0,g1,g2,g3;
-        if (sscanf(line, "guess%d=%c%c%c%c black=%d white=%d",
-                   &idx, &g0,&g1,&g2,&g3, &black,&white)==7) {
-            int i=idx-1;
-            gs->guesses[i][0]=g0; gs->guesses[i][1]=g1;
-            gs->guesses[i][2]=g2; gs->guesses[i][3]=g3;
-            gs->blacks[i]=black; gs->whites[i]=white;
-        }
+    const char *p = texte;
+    while (*p) {
+        const char *fin = strchr(p, '\n');
+        size_t n = fin ? (size_t)(fin - p) : strlen(p);
+        if (n >= sizeof(line)) n = sizeof(line) - 1;
+        memcpy(line, p, n);
+        line[n] = '\0';
+        analyser_ligne(gs, line);
+        if (!fin) break;
+        p = fin + 1;
     }
+    return gs->tries >= 0 && gs->tries <= 64;
+}
+
+bool sauvegarder_partie(const GameState *gs, const char *chemin) {
+    char buf[4096];
+    size_t n = formater_partie(gs, buf, sizeof(buf));
+    if (n >= sizeof(buf)) return false;
+    FILE *f = fopen(chemin, "w");
+    if (!f) return false;
+    fwrite(buf, 1, n, f);
     fclose(f);
     return true;
 }
+
+bool charger_partie(GameState *gs, const char *chemin) {
+    FILE *f = fopen(chemin, "r");
+    if (!f) return false;
+    char buf[4096];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    return analyser_partie(gs, buf);
+}
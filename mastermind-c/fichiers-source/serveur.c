@@ -0,0 +1,549 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include "serveur.h"
+#include "configuration.h"
+#include "moteur.h"
+#include "alea.h"
+#include "agregateur_stats.h"
+#include "horloge.h"
+#include "minuteurs.h"
+#include "pool.h"
+
+#define TAILLE_ENTREE 1024
+#define MAX_EVENEMENTS 256
+#define SORTIE_MAX (256 * 1024)         // réponses en attente au-delà desquelles on ne lit plus
+#define INACTIVITE_MS (10 * 60 * 1000)  // délai avant libération d'une session oubliée
+
+typedef struct {
+    int fd;
+    char entree[TAILLE_ENTREE];
+    size_t nb_entree;
+    char *sortie;
+    size_t nb_sortie, capacite_sortie, envoye;
+    uint32_t evenements;    // masque epoll en place
+    bool en_erreur;         // réponse perdue (mémoire) : connexion à fermer
+} Connexion;
+
+/* ============================================================
+   Table des sessions : adressage ouvert, clé = identifiant
+   ============================================================ */
+
+// Le minuteur d'inactivité ne doit pas bouger : la table, qui déplace ses
+// cases, ne garde qu'un pointeur vers l'enregistrement
+typedef struct {
+    Minuteur inactivite;    // premier champ : retrouvé depuis le rappel
+    uint64_t id;
+    Session *session;
+} SessionServeur;
+
+typedef struct {
+    uint64_t id;            // 0 = case vide
+    SessionServeur *ss;
+} EntreeSession;
+
+typedef struct {
+    EntreeSession *cases;
+    size_t capacite;        // puissance de deux
+    size_t nb;
+    uint64_t prochain_id;
+} TableSessions;
+
+static size_t hacher(uint64_t id, size_t capacite) {
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdULL;
+    id ^= id >> 33;
+    return (size_t)id & (capacite - 1);
+}
+
+static bool table_init(TableSessions *t, size_t capacite) {
+    t->cases = calloc(capacite, sizeof(EntreeSession));
+    t->capacite = capacite;
+    t->nb = 0;
+    t->prochain_id = 1;
+    return t->cases != NULL;
+}
+
+static EntreeSession *table_chercher(TableSessions *t, uint64_t id) {
+    for (size_t i = hacher(id, t->capacite);; i = (i + 1) & (t->capacite - 1)) {
+        if (t->cases[i].id == id) return &t->cases[i];
+        if (t->cases[i].id == 0) return NULL;
+    }
+}
+
+static void table_placer(TableSessions *t, EntreeSession e) {
+    size_t i = hacher(e.id, t->capacite);
+    while (t->cases[i].id != 0) i = (i + 1) & (t->capacite - 1);
+    t->cases[i] = e;
+    t->nb++;
+}
+
+static bool table_ajouter(TableSessions *t, SessionServeur *ss) {
+    if ((t->nb + 1) * 4 > t->capacite * 3) {
+        TableSessions grande;
+        if (!table_init(&grande, t->capacite * 2)) return false;
+        grande.prochain_id = t->prochain_id;
+        for (size_t i=0;i<t->capacite;i++)
+            if (t->cases[i].id) table_placer(&grande, t->cases[i]);
+        free(t->cases);
+        *t = grande;
+    }
+    ss->id = t->prochain_id++;
+    EntreeSession e = { ss->id, ss };
+    table_placer(t, e);
+    return true;
+}
+
+// Suppression par recul des éléments suivants (pas de pierres tombales)
+static void table_retirer(TableSessions *t, EntreeSession *e) {
+    size_t masque = t->capacite - 1;
+    size_t trou = (size_t)(e - t->cases);
+    size_t i = trou;
+    t->cases[trou].id = 0;
+    t->nb--;
+    for (;;) {
+        i = (i + 1) & masque;
+        if (t->cases[i].id == 0) return;
+        size_t ideal = hacher(t->cases[i].id, t->capacite);
+        // L'élément peut-il remonter dans le trou sans casser sa chaîne ?
+        if (((i - ideal) & masque) >= ((i - trou) & masque)) {
+            t->cases[trou] = t->cases[i];
+            t->cases[i].id = 0;
+            trou = i;
+        }
+    }
+}
+
+/* ============================================================
+   Entrées / sorties des connexions
+   ============================================================ */
+
+static int epfd = -1;
+static int tfd = -1;                // timerfd de la roue de minuteurs
+static RoueMinuteurs roue;             // échéances des tentatives
+static RoueMinuteurs roue_inactivite;   // une entrée par session
+static Pool pool_sessions;              // enregistrements SessionServeur
+static uint64_t reveil_programme = UINT64_MAX;
+static Alea alea_serveur;       // tire la graine de chaque nouvelle session
+static TableSessions sessions;
+static AgregateurStats *stats_serveur;
+
+static void repondre(Connexion *c, const char *fmt, ...) {
+    for (;;) {
+        size_t libre = c->capacite_sortie - c->nb_sortie;
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(c->sortie + c->nb_sortie, libre, fmt, ap);
+        va_end(ap);
+        if (n < 0) return;
+        if ((size_t)n < libre) { c->nb_sortie += (size_t)n; return; }
+        size_t cap = c->capacite_sortie ? c->capacite_sortie * 2 : 256;
+        while (cap - c->nb_sortie <= (size_t)n) cap *= 2;
+        char *p = realloc(c->sortie, cap);
+        if (!p) { c->en_erreur = true; return; }
+        c->sortie = p;
+        c->capacite_sortie = cap;
+    }
+}
+
+static void fermer_connexion(Connexion *c) {
+    epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    free(c->sortie);
+    free(c);
+}
+
+// Un client qui envoie sans lire ne fait pas grossir la sortie sans fin :
+// passé SORTIE_MAX en attente, ses requêtes restent dans le tampon
+// d'entrée et la socket n'est plus lue jusqu'à ce que la sortie se vide.
+static bool sortie_saturee(const Connexion *c) {
+    return c->nb_sortie - c->envoye > SORTIE_MAX;
+}
+
+static void traiter_entree(Connexion *c);
+
+// Envoie ce qui est en attente, reprend les requêtes retenues par la
+// saturation et ajuste le masque epoll ; false si la connexion est morte
+static bool vider_sortie(Connexion *c) {
+    for (;;) {
+        while (c->envoye < c->nb_sortie) {
+            ssize_t n = send(c->fd, c->sortie + c->envoye,
+                             c->nb_sortie - c->envoye, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            c->envoye += (size_t)n;
+        }
+        if (c->envoye == c->nb_sortie) c->envoye = c->nb_sortie = 0;
+        if (sortie_saturee(c) || !memchr(c->entree, '\n', c->nb_entree)) break;
+        traiter_entree(c);
+        if (c->en_erreur) return false;
+    }
+
+    uint32_t evenements = (sortie_saturee(c) ? 0 : EPOLLIN)
+                        | (c->nb_sortie > 0 ? EPOLLOUT : 0);
+    if (evenements != c->evenements) {
+        struct epoll_event ev = { .events = evenements, .data.ptr = c };
+        epoll_ctl(epfd, EPOLL_CTL_MOD, c->fd, &ev);
+        c->evenements = evenements;
+    }
+    return true;
+}
+
+/* ============================================================
+   Échéances des sessions chronométrées
+   ============================================================ */
+
+// Timerfd en un coup, calé sur la prochaine échéance : aucun réveil
+// tant qu'aucune session chronométrée n'est en attente.
+static void programmer_timerfd(void) {
+    uint64_t reveil = roue_prochain_reveil(&roue);
+    uint64_t inactif = roue_prochain_reveil(&roue_inactivite);
+    if (inactif < reveil) reveil = inactif;
+    if (reveil == reveil_programme) return;
+    struct itimerspec it = { { 0, 0 }, { 0, 0 } };
+    if (reveil != UINT64_MAX) {
+        uint64_t t = horloge_ms();
+        uint64_t attente = reveil > t ? reveil - t : 1;
+        it.it_value.tv_sec = (time_t)(attente / 1000);
+        it.it_value.tv_nsec = (long)(attente % 1000) * 1000000L;
+    }
+    timerfd_settime(tfd, 0, &it, NULL);
+    reveil_programme = reveil;
+}
+
+static void retirer_session(EntreeSession *e) {
+    SessionServeur *ss = e->ss;
+    roue_annuler(&roue_inactivite, &ss->inactivite);
+    session_detruire(ss->session);
+    pool_liberer(&pool_sessions, ss);
+    table_retirer(&sessions, e);
+}
+
+static void toucher(SessionServeur *ss) {
+    roue_armer(&roue_inactivite, &ss->inactivite, horloge_ms() + INACTIVITE_MS);
+}
+
+static void abandonner(EntreeSession *e) {
+    Session *s = e->ss->session;
+    agregateur_enregistrer(stats_serveur, false, session_tentatives(s),
+                           (double)session_duree_ns(s) / 1e9);
+    retirer_session(e);
+}
+
+// Session sans requête depuis INACTIVITE_MS : comptée comme abandonnée
+static void inactivite_atteinte(Minuteur *m, void *ctx) {
+    (void)ctx;
+    EntreeSession *e = table_chercher(&sessions, ((SessionServeur *)m)->id);
+    if (e) abandonner(e);
+}
+
+// Partie perdue faute de propositions (client parti) : comptée puis libérée
+static void partie_perdue(Session *s, void *ctx) {
+    (void)ctx;
+    EntreeSession *e = table_chercher(&sessions, session_etiquette(s));
+    if (e) abandonner(e);
+}
+
+static void traiter_timerfd(void) {
+    uint64_t ticks;
+    if (read(tfd, &ticks, sizeof(ticks)) != (ssize_t)sizeof(ticks)) return;
+    reveil_programme = UINT64_MAX - 1;      // à reprogrammer
+    uint64_t t = horloge_ms();
+    sessions_avancer_echeances(&roue, t, partie_perdue, NULL);
+    roue_avancer(&roue_inactivite, t, inactivite_atteinte, NULL);
+}
+
+/* ============================================================
+   Commandes du protocole
+   ============================================================ */
+
+static const char *nom_etat(EtatPartie e) {
+    switch (e) {
+        case PARTIE_GAGNEE: return "GAGNE";
+        case PARTIE_PERDUE: return "PERDU";
+        default:            return "ENCOURS";
+    }
+}
+
+static void cmd_new(Connexion *c, const char *args) {
+    GameConfig cfg;
+    config_defaut(&cfg);
+    int cc, tries, rep, chrono = 0, sec = 0;
+    int n = sscanf(args, "%d %d %d %d %d", &cc, &tries, &rep, &chrono, &sec);
+    if (n >= 3) {
+        cfg.color_count = cc;
+        cfg.max_tries = tries;
+        cfg.allow_repetition = rep != 0;
+        cfg.timed_mode = chrono != 0;
+        cfg.time_per_try_sec = cfg.timed_mode ? sec : 0;
+    } else if (n > 0) {
+        repondre(c, "ERR arguments\n");
+        return;
+    }
+    Session *s = session_creer(&cfg, alea_suivant(&alea_serveur));
+    if (!s) { repondre(c, "ERR configuration\n"); return; }
+    SessionServeur *ss = pool_allouer(&pool_sessions);
+    if (!ss || !table_ajouter(&sessions, ss)) {
+        if (ss) pool_liberer(&pool_sessions, ss);
+        session_detruire(s);
+        repondre(c, "ERR memoire\n");
+        return;
+    }
+    ss->session = s;
+    ss->inactivite.suivant = ss->inactivite.precedent = NULL;
+    session_fixer_etiquette(s, ss->id);
+    session_armer_echeance(s, &roue, horloge_ms());
+    toucher(ss);
+    repondre(c, "OK %llu\n", (unsigned long long)ss->id);
+}
+
+static void cmd_guess(Connexion *c, const char *args) {
+    // Le code est lu sur place dans le tampon d'entrée, sans copie
+    char *code;
+    unsigned long long id = strtoull(args, &code, 10);
+    while (*code == ' ') code++;
+    if (code == args || *code == '\0') { repondre(c, "ERR arguments\n"); return; }
+    EntreeSession *e = table_chercher(&sessions, id);
+    if (!e) { repondre(c, "ERR session\n"); return; }
+    Session *s = e->ss->session;
+    toucher(e->ss);
+
+    int noirs, blancs;
+    ResultatCoup r = session_proposer_texte(s, code, &noirs, &blancs);
+    if (r == COUP_INVALIDE) { repondre(c, "ERR invalide\n"); return; }
+    if (r == COUP_HORS_DELAI) { repondre(c, "ERR delai\n"); return; }
+
+    EtatPartie etat = session_etat(s);
+    if (etat == PARTIE_EN_COURS) {
+        repondre(c, "FB %d %d ENCOURS\n", noirs, blancs);
+        return;
+    }
+    char secret[CODE_LEN];
+    session_secret(s, secret);
+    repondre(c, "FB %d %d %s %.*s\n", noirs, blancs, nom_etat(etat), CODE_LEN, secret);
+    agregateur_enregistrer(stats_serveur, etat == PARTIE_GAGNEE,
+                           session_tentatives(s),
+                           (double)session_duree_ns(s) / 1e9);
+    retirer_session(e);
+}
+
+static void cmd_resume(Connexion *c, const char *args) {
+    unsigned long long id;
+    if (sscanf(args, "%llu", &id) != 1) { repondre(c, "ERR arguments\n"); return; }
+    EntreeSession *e = table_chercher(&sessions, id);
+    if (!e) { repondre(c, "ERR session\n"); return; }
+    const Session *s = e->ss->session;
+    toucher(e->ss);
+    repondre(c, "STATE %llu %d %d %s", id, session_tentatives(s),
+             session_config(s)->max_tries, nom_etat(session_etat(s)));
+    for (int i=0;i<session_tentatives(s);i++) {
+        char code[CODE_LEN]; int noirs, blancs;
+        session_coup(s, i, code, &noirs, &blancs);
+        repondre(c, " %.*s:%d:%d", CODE_LEN, code, noirs, blancs);
+    }
+    repondre(c, "\n");
+}
+
+static void cmd_end(Connexion *c, const char *args) {
+    unsigned long long id;
+    if (sscanf(args, "%llu", &id) != 1) { repondre(c, "ERR arguments\n"); return; }
+    EntreeSession *e = table_chercher(&sessions, id);
+    if (!e) { repondre(c, "ERR session\n"); return; }
+    abandonner(e);
+    repondre(c, "OK %llu\n", id);
+}
+
+static void cmd_stats(Connexion *c) {
+    Stats st;
+    agregateur_lire(stats_serveur, &st);
+    repondre(c, "STATS %lu %lu %lu %.6f\n", st.games_played, st.games_won,
+             st.total_tries, st.total_time);
+}
+
+static void cmd_mem(Connexion *c) {
+    MemoireSessions m;
+    session_memoire(&m);
+    repondre(c, "MEM %lu %zu %.0f", m.vivantes, m.octets_par_session,
+             m.allocations_par_sec);
+    for (int i=0;i<SESSION_NB_CLASSES;i++)
+        repondre(c, " %d:%zu:%lu", m.classes[i].max_tries,
+                 m.classes[i].pool.taille, m.classes[i].pool.vivants);
+    repondre(c, "\n");
+}
+
+static void traiter_ligne(Connexion *c, char *ligne) {
+    char *args = strchr(ligne, ' ');
+    if (args) *args++ = '\0'; else args = ligne + strlen(ligne);
+
+    if (strcmp(ligne, "GUESS") == 0)       cmd_guess(c, args);
+    else if (strcmp(ligne, "NEW") == 0)    cmd_new(c, args);
+    else if (strcmp(ligne, "RESUME") == 0) cmd_resume(c, args);
+    else if (strcmp(ligne, "END") == 0)    cmd_end(c, args);
+    else if (strcmp(ligne, "STATS") == 0)  cmd_stats(c);
+    else if (strcmp(ligne, "MEM") == 0)    cmd_mem(c);
+    else if (ligne[0] != '\0')             repondre(c, "ERR commande\n");
+}
+
+// Traite les lignes complètes reçues, tant que la sortie n'est pas saturée
+static void traiter_entree(Connexion *c) {
+    // Les réponses s'ajoutent derrière ce qui reste à envoyer
+    if (c->envoye) {
+        memmove(c->sortie, c->sortie + c->envoye, c->nb_sortie - c->envoye);
+        c->nb_sortie -= c->envoye;
+        c->envoye = 0;
+    }
+    size_t debut = 0;
+    for (size_t i=0;i<c->nb_entree && !sortie_saturee(c);i++) {
+        if (c->entree[i] != '\n') continue;
+        c->entree[i] = '\0';
+        if (i > debut && c->entree[i-1] == '\r') c->entree[i-1] = '\0';
+        traiter_ligne(c, c->entree + debut);
+        debut = i + 1;
+    }
+    memmove(c->entree, c->entree + debut, c->nb_entree - debut);
+    c->nb_entree -= debut;
+}
+
+// Lit ce qui est disponible et traite les lignes complètes
+static bool lire_connexion(Connexion *c) {
+    if (sortie_saturee(c)) return vider_sortie(c);
+    ssize_t n = recv(c->fd, c->entree + c->nb_entree,
+                     sizeof(c->entree) - c->nb_entree, 0);
+    if (n == 0) return false;
+    if (n < 0) return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+    c->nb_entree += (size_t)n;
+
+    traiter_entree(c);
+    if (c->en_erreur) return false;
+    // Tampon plein sans fin de ligne traitable : ligne trop longue
+    if (!sortie_saturee(c) && c->nb_entree == sizeof(c->entree)) return false;
+    return vider_sortie(c);
+}
+
+/* ============================================================
+   Boucle principale
+   ============================================================ */
+
+static int ouvrir_socket(const char *chemin) {
+    struct sockaddr_un adr;
+    if (strlen(chemin) >= sizeof(adr.sun_path)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    memset(&adr, 0, sizeof(adr));
+    adr.sun_family = AF_UNIX;
+    strcpy(adr.sun_path, chemin);
+    unlink(chemin);
+    if (bind(fd, (struct sockaddr *)&adr, sizeof(adr)) != 0
+        || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void accepter(int lfd) {
+    for (;;) {
+        int fd = accept4(lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        Connexion *c = calloc(1, sizeof(*c));
+        if (!c) { close(fd); continue; }
+        c->fd = fd;
+        c->evenements = EPOLLIN;
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = c };
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            free(c);
+        }
+    }
+}
+
+bool lancer_serveur(const char *chemin_socket) {
+    static char marque_ecoute, marque_signal, marque_minuteur;
+
+    sigset_t masque;
+    sigemptyset(&masque);
+    sigaddset(&masque, SIGINT);
+    sigaddset(&masque, SIGTERM);
+    sigprocmask(SIG_BLOCK, &masque, NULL);
+
+    // Signaux bloqués avant de créer le thread de sauvegarde des stats,
+    // pour qu'ils n'arrivent que par le signalfd de la boucle
+    AgregateurStats stats;
+    agregateur_init(&stats, "stats.txt", 5000, true);
+    stats_serveur = &stats;
+    alea_init(&alea_serveur, alea_graine_systeme());
+
+    int lfd = ouvrir_socket(chemin_socket);
+    if (lfd < 0 || !table_init(&sessions, 1024)) {
+        fprintf(stderr, "Impossible d'ecouter sur %s\n", chemin_socket);
+        agregateur_fermer(&stats);
+        return false;
+    }
+
+    int sfd = signalfd(-1, &masque, SFD_NONBLOCK | SFD_CLOEXEC);
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &marque_ecoute };
+    epoll_ctl(epfd, EPOLL_CTL_ADD, lfd, &ev);
+    ev.data.ptr = &marque_signal;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, sfd, &ev);
+    tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    roue_init(&roue, horloge_ms());
+    roue_init(&roue_inactivite, horloge_ms());
+    pool_init(&pool_sessions, sizeof(SessionServeur));
+    ev.data.ptr = &marque_minuteur;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, tfd, &ev);
+
+    fprintf(stderr, "Serveur Mastermind a l'ecoute sur %s\n", chemin_socket);
+
+    struct epoll_event evs[MAX_EVENEMENTS];
+    bool continuer = true;
+    while (continuer) {
+        int n = epoll_wait(epfd, evs, MAX_EVENEMENTS, -1);
+        if (n < 0 && errno != EINTR) break;
+        for (int i=0;i<n;i++) {
+            void *p = evs[i].data.ptr;
+            if (p == &marque_ecoute) { accepter(lfd); continue; }
+            if (p == &marque_signal) { continuer = false; continue; }
+            if (p == &marque_minuteur) { traiter_timerfd(); continue; }
+
+            Connexion *c = p;
+            bool vivante = true;
+            if (evs[i].events & (EPOLLERR | EPOLLHUP) && !(evs[i].events & EPOLLIN))
+                vivante = false;
+            if (vivante && (evs[i].events & EPOLLIN)) vivante = lire_connexion(c);
+            if (vivante && (evs[i].events & EPOLLOUT)) vivante = vider_sortie(c);
+            if (!vivante) fermer_connexion(c);
+        }
+        programmer_timerfd();
+    }
+
+    fprintf(stderr, "Arret du serveur (%zu sessions actives).\n", sessions.nb);
+    for (size_t i=0;i<sessions.capacite;i++) {
+        if (!sessions.cases[i].id) continue;
+        session_detruire(sessions.cases[i].ss->session);
+    }
+    free(sessions.cases);
+    pool_detruire(&pool_sessions);
+    close(lfd);
+    close(sfd);
+    close(tfd);
+    close(epfd);
+    unlink(chemin_socket);
+    agregateur_fermer(&stats);
+    return true;
+}
@@ -0,0 +1,718 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "solveur.h"
+#include "solveur_noyaux.h"
+#include "cache_feedback.h"
+#include "parse.h"
+#include "rang.h"
+#include "couleurs.h"
+#include "feedback.h"
+#include "horloge.h"
+#include "trace.h"
+
+/* ============================================================
+   Solveur (heuristique type Knuth), sans entrées/sorties
+   ============================================================ */
+
+/* Les tableaux par code suivent la structure, dans le même bloc, à la
+   taille exacte de l'espace (rang dense, rang.h) : 360 codes sans
+   répétition au lieu de 1296. L'indice d'un code est son rang. Chaque
+   code a sa signature (feedback.h), calculée une fois à la création. */
+struct Solveur {
+    int nb_possibles;   // taille de l'espace des codes
+    int restants;       // codes encore actifs
+    int couleurs;
+    bool repetitions;
+    char (*possibles)[CODE_LEN];
+    SignatureCode *signatures;
+    bool *actif;
+    uint16_t *scores;       // pire case au tour précédent
+    uint8_t *partition;     // case de chaque actif pour la proposition
+    char proposition[CODE_LEN];             // dernière proposition faite
+    bool partition_valide;
+    CompteursSolveur cpt;
+    CacheFeedback *cache;                   // facultatif, fourni par l'appelant
+    uint64_t evictions_depart;              // évictions du cache à l'attache
+
+    // Mode incrémental : histogramme des cases de chaque proposition active
+    // contre les candidats actifs, tenu à jour au filtrage
+    ModeSolveur mode;
+    int cle_config;                 // entrée du cache des histogrammes initiaux
+    uint16_t (*hist)[25];
+    bool hist_valide;
+};
+
+
+// Génère toutes les combinaisons possibles selon la config, dans l'ordre
+// de leur rang (rang.h) : codes[code_rang(c)] == c
+int generate_all_codes(char codes[][CODE_LEN], const GameConfig *cfg)
+{
+    int count = 0;
+
+    if (cfg->allow_repetition) {
+        for (int i0 = 0; i0 < cfg->color_count; i0++)
+        for (int i1 = 0; i1 < cfg->color_count; i1++)
+        for (int i2 = 0; i2 < cfg->color_count; i2++)
+        for (int i3 = 0; i3 < cfg->color_count; i3++) {
+            codes[count][0] = GLOBAL_COLOR_SET[i0];
+            codes[count][1] = GLOBAL_COLOR_SET[i1];
+            codes[count][2] = GLOBAL_COLOR_SET[i2];
+            codes[count][3] = GLOBAL_COLOR_SET[i3];
+            count++;
+        }
+    } else {
+        for (int i0 = 0; i0 < cfg->color_count; i0++)
+        for (int i1 = 0; i1 < cfg->color_count; i1++) if (i1 != i0)
+        for (int i2 = 0; i2 < cfg->color_count; i2++) if (i2 != i0 && i2 != i1)
+        for (int i3 = 0; i3 < cfg->color_count; i3++) if (i3 != i0 && i3 != i1 && i3 != i2) {
+            codes[count][0] = GLOBAL_COLOR_SET[i0];
+            codes[count][1] = GLOBAL_COLOR_SET[i1];
+            codes[count][2] = GLOBAL_COLOR_SET[i2];
+            codes[count][3] = GLOBAL_COLOR_SET[i3];
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void signer_codes(char codes[][CODE_LEN], int nb_codes, SignatureCode signatures[])
+{
+    for (int i = 0; i < nb_codes; i++)
+        signature_code(codes[i], &signatures[i]);
+}
+
+// Case noirs*5+blancs du code c contre la proposition g : lue dans la ligne
+// de g si le cache la connaît, calculée (et notée) sinon
+static inline int case_feedback(const SignatureCode signatures[], int c, int g,
+                                uint8_t *ligne, CompteursSolveur *cpt)
+{
+    if (ligne) {
+        uint8_t k = cache_feedback_lire(ligne, c);
+        if (k != CACHE_CASE_INCONNUE) {
+            cpt->cache_hits++;
+            return k;
+        }
+    }
+    int k = case_signatures(signatures[c], signatures[g]);
+    cpt->feedbacks++;
+    if (ligne) cache_feedback_ecrire(ligne, c, k);
+    return k;
+}
+
+// Évalue la proposition g : on cherche la pire partition possible.
+// L'évaluation s'arrête dès qu'une case atteint « borne » (g ne peut plus
+// l'emporter) et renvoie alors une valeur >= borne. La case de chaque
+// candidat actif (noirs*5+blancs) est notée dans « cases ». « ligne » est
+// la ligne de g dans le cache de feedbacks, ou NULL.
+static int evaluate_guess(int g,
+                          const SignatureCode signatures[],
+                          const bool actif[],
+                          int nb_possibles,
+                          int borne,
+                          uint8_t cases[],
+                          uint8_t *ligne,
+                          uint64_t *evalues,
+                          CompteursSolveur *cpt)
+{
+    int counts[25];
+    for (int i = 0; i < 25; i++) counts[i] = 0;
+
+    int worst = 0;
+    uint64_t n = 0;
+    for (int i = 0; i < nb_possibles; i++) {
+        if (!actif[i]) continue;
+        int k = case_feedback(signatures, i, g, ligne, cpt);
+        n++;
+        cases[i] = (uint8_t)k;
+        int c = ++counts[k];
+        if (c > worst) {
+            worst = c;
+            if (worst >= borne) break;
+        }
+    }
+
+    *evalues += n;
+    return worst;
+}
+
+// Le cache ne sert que si les lignes du tour y tiennent toutes : au-delà,
+// chaque ligne serait recyclée avant d'être relue
+static CacheFeedback *cache_utile(CacheFeedback *cache, int actifs)
+{
+    if (!cache) return NULL;
+    InfosCache infos;
+    cache_feedback_infos(cache, &infos);
+    return actifs <= infos.capacite ? cache : NULL;
+}
+
+// Classe les candidats actifs par score du tour précédent, les plus
+// prometteurs d'abord (tri par dénombrement, stable) : une bonne borne
+// trouvée tôt coupe davantage d'évaluations. Sans scores, ordre des indices.
+static int ordonner_candidats(int ordre[], const bool actif[], int nb_possibles,
+                              const uint16_t scores[])
+{
+    int nb = 0;
+    if (!scores) {
+        for (int i = 0; i < nb_possibles; i++)
+            if (actif[i]) ordre[nb++] = i;
+        return nb;
+    }
+    static _Thread_local int effectifs[SOLVEUR_MAX_CODES + 2];
+    memset(effectifs, 0, sizeof(effectifs));
+    for (int i = 0; i < nb_possibles; i++)
+        if (actif[i]) effectifs[scores[i] + 1]++;
+    for (int e = 1; e < SOLVEUR_MAX_CODES + 2; e++)
+        effectifs[e] += effectifs[e - 1];
+    for (int i = 0; i < nb_possibles; i++)
+        if (actif[i]) ordre[effectifs[scores[i]]++] = i, nb++;
+    return nb;
+}
+
+// Choisit la meilleure proposition : la plus petite pire case, à égalité
+// le plus petit indice. Le résultat ne dépend donc pas de l'ordre
+// d'évaluation, ce qui garde le rejeu des parties de l'IA identique.
+// « scores » (facultatif) garde d'un tour à l'autre la pire case de chaque
+// candidat (un minorant si l'évaluation a été coupée) pour l'ordre.
+// « partition » (facultatif) reçoit la case de chaque candidat actif pour
+// la proposition retenue ; renvoie faux si elle n'a pas pu être calculée.
+// « cache » (facultatif) garde les feedbacks calculés pour les tours suivants.
+bool choose_next_guess(char guess_out[CODE_LEN],
+                       char possibles[][CODE_LEN],
+                       const SignatureCode signatures[],
+                       bool actif[],
+                       int nb_possibles,
+                       uint16_t scores[],
+                       uint8_t partition[],
+                       CacheFeedback *cache,
+                       CompteursSolveur *cpt)
+{
+    int best_score = 999999;
+    int best_index = -1;
+
+    int actifs = 0;
+    for (int i = 0; i < nb_possibles; i++)
+        actifs += actif[i];
+
+    static _Thread_local int ordre[SOLVEUR_MAX_CODES];
+    static _Thread_local uint8_t cases[SOLVEUR_MAX_CODES];
+    int nb = ordonner_candidats(ordre, actif, nb_possibles, scores);
+    cache = cache_utile(cache, nb);
+
+    for (int k = 0; k < nb; k++) {
+        int i = ordre[k];
+        // Un indice plus petit que le meilleur gagne aussi à égalité
+        int borne = (best_index < 0 || i < best_index) ? best_score + 1 : best_score;
+        uint64_t faits = 0;
+        uint8_t *ligne = cache ? cache_feedback_ligne(cache, i) : NULL;
+        int score = evaluate_guess(i, signatures, actif, nb_possibles,
+                                   borne, cases, ligne, &faits, cpt);
+        cpt->partitions++;
+        if (faits < (uint64_t)actifs) {
+            cpt->evaluations_coupees++;
+            cpt->feedbacks_evites += (uint64_t)actifs - faits;
+        }
+        if (scores) scores[i] = (uint16_t)score;
+        // Un nouveau meilleur n'a jamais été coupé : sa partition est complète
+        if (score < best_score || (score == best_score && i < best_index)) {
+            best_score = score;
+            best_index = i;
+            if (partition) memcpy(partition, cases, (size_t)nb_possibles);
+        }
+    }
+
+    bool complete = best_index >= 0;
+    if (best_index == -1) {
+        for (int i = 0; i < nb_possibles; i++)
+            if (actif[i]) { best_index = i; break; }
+    }
+
+    memcpy(guess_out, possibles[best_index], CODE_LEN);
+    return complete;
+}
+
+// Filtre en gardant une case de la partition calculée au choix : aucun
+// feedback à recalculer
+static int filtrer_par_partition(bool actif[], int nb_possibles,
+                                 const uint8_t partition[], int case_gardee)
+{
+    int count = 0;
+    for (int i = 0; i < nb_possibles; i++) {
+        if (!actif[i]) continue;
+        if (partition[i] == case_gardee) count++;
+        else actif[i] = false;
+    }
+    return count;
+}
+
+// Filtre les possibilités selon le feedback
+int filter_possibilities(const SignatureCode signatures[],
+                         bool actif[],
+                         int nb_possibles,
+                         const char guess[CODE_LEN],
+                         int black_expected,
+                         int white_expected,
+                         CompteursSolveur *cpt)
+{
+    int count = 0;
+    // Une proposition hors palette ne correspond à aucun code
+    SignatureCode sg = { 0, 0 };
+    int attendue = signature_code(guess, &sg) ? black_expected * 5 + white_expected : -1;
+
+    for (int i = 0; i < nb_possibles; i++) {
+        if (!actif[i]) continue;
+        cpt->feedbacks++;
+
+        if (case_signatures(signatures[i], sg) == attendue)
+            count++;
+        else
+            actif[i] = false;
+    }
+
+    return count;
+}
+
+/* Filtrage par tout un historique (reprise d'une partie, aide au joueur) :
+   une seule passe sur l'espace des codes, par blocs de CONTRAINTES_BLOC
+   codes. La première contrainte est testée sur tout le bloc d'un coup
+   (boucle de longueur fixe, sans branchement) ; elle élimine l'essentiel
+   des codes, et chaque survivant passe ensuite les autres une à une,
+   jusqu'au premier échec. La dernière contrainte à avoir éliminé un code
+   passe en tête pour le bloc suivant : elle a des chances d'y éliminer
+   aussi. */
+#define CONTRAINTES_BLOC 16
+
+int filtrer_contraintes(const SignatureCode signatures[],
+                        bool actif[],
+                        int nb_possibles,
+                        const SignatureCode propositions[],
+                        const uint8_t cases[],
+                        int nb_contraintes,
+                        CompteursSolveur *cpt)
+{
+    static _Thread_local int ordre[256];
+    if (nb_contraintes > 256) nb_contraintes = 256;
+    for (int j = 0; j < nb_contraintes; j++) ordre[j] = j;
+
+    int count = 0;
+    uint64_t n = 0;
+    for (int b0 = 0; b0 < nb_possibles; b0 += CONTRAINTES_BLOC) {
+        int largeur = nb_possibles - b0 < CONTRAINTES_BLOC ? nb_possibles - b0
+                                                            : CONTRAINTES_BLOC;
+        const SignatureCode *sig = signatures + b0;
+        uint32_t vivants = 0;
+        for (int l = 0; l < largeur; l++)
+            vivants |= (uint32_t)actif[b0 + l] << l;
+
+        if (nb_contraintes > 0 && vivants) {
+            SignatureCode g = propositions[ordre[0]];
+            int attendue = cases[ordre[0]];
+            uint32_t ok = 0;
+            if (largeur == CONTRAINTES_BLOC) {
+                for (int l = 0; l < CONTRAINTES_BLOC; l++)
+                    ok |= (uint32_t)(case_signatures(sig[l], g) == attendue) << l;
+            } else {
+                for (int l = 0; l < largeur; l++)
+                    ok |= (uint32_t)(case_signatures(sig[l], g) == attendue) << l;
+            }
+            n += (uint64_t)largeur;
+            vivants &= ok;
+        }
+
+        int derniere = 0;   // rang de la dernière contrainte éliminatoire
+        for (uint32_t v = vivants; v; v &= v - 1) {
+            int l = __builtin_ctz(v);
+            for (int j = 1; j < nb_contraintes; j++) {
+                int c = ordre[j];
+                n++;
+                if (case_signatures(sig[l], propositions[c]) != cases[c]) {
+                    vivants &= ~(1u << l);
+                    derniere = j;
+                    break;
+                }
+            }
+        }
+        if (derniere > 0) {
+            int c = ordre[derniere];
+            memmove(ordre + 1, ordre, (size_t)derniere * sizeof(ordre[0]));
+            ordre[0] = c;
+        }
+
+        for (int l = 0; l < largeur; l++)
+            actif[b0 + l] = (vivants >> l) & 1;
+        count += __builtin_popcount(vivants);
+    }
+
+    cpt->feedbacks += n;
+    return count;
+}
+
+/* ============================================================
+   Histogrammes incrémentaux
+   ============================================================ */
+
+/* D'un tour à l'autre l'ensemble des actifs ne fait que diminuer : on peut
+   retirer de chaque histogramme les candidats éliminés (E x S feedbacks)
+   au lieu de tout recalculer (S x S). Le filtrage choisit le moins cher.
+   Les histogrammes de départ ne dépendent que de la configuration : ils
+   sont calculés une fois par processus et copiés ensuite. */
+
+#define NB_CLES_CONFIG ((MAX_COLORS - MIN_COLORS + 1) * 2)
+
+static pthread_mutex_t verrou_initiaux = PTHREAD_MUTEX_INITIALIZER;
+static uint16_t (*hist_initiaux[NB_CLES_CONFIG])[25];
+
+// Version directe : une proposition à la fois contre tout l'espace des codes
+uint64_t histogrammes_direct(const SignatureCode signatures[], const bool actif[],
+                             int nb_possibles, uint16_t hist[][25])
+{
+    uint64_t n = 0;
+    for (int g = 0; g < nb_possibles; g++) {
+        if (!actif[g]) continue;
+        memset(hist[g], 0, sizeof(hist[g]));
+        for (int c = 0; c < nb_possibles; c++) {
+            if (!actif[c]) continue;
+            hist[g][case_signatures(signatures[c], signatures[g])]++;
+            n++;
+        }
+    }
+    return n;
+}
+
+/* Version par tuiles : les actifs sont d'abord regroupés dans un tableau
+   contigu (plus de test actif[] dans la boucle interne), puis chaque bloc
+   de TUILE_PROPOSITIONS histogrammes est rempli bloc de candidats par bloc
+   de candidats, pour que les deux restent en cache L1. */
+#define TUILE_PROPOSITIONS 8
+#define TUILE_CANDIDATS 512
+
+uint64_t histogrammes_tuiles(const SignatureCode signatures[], const bool actif[],
+                             int nb_possibles, uint16_t hist[][25])
+{
+    static _Thread_local int indices[SOLVEUR_MAX_CODES];
+    static _Thread_local SignatureCode sig[SOLVEUR_MAX_CODES];
+    int n = 0;
+    for (int i = 0; i < nb_possibles; i++) {
+        if (!actif[i]) continue;
+        indices[n] = i;
+        sig[n] = signatures[i];
+        n++;
+    }
+
+    for (int g0 = 0; g0 < n; g0 += TUILE_PROPOSITIONS) {
+        int g1 = g0 + TUILE_PROPOSITIONS < n ? g0 + TUILE_PROPOSITIONS : n;
+        for (int g = g0; g < g1; g++)
+            memset(hist[indices[g]], 0, sizeof(hist[0]));
+
+        for (int c0 = 0; c0 < n; c0 += TUILE_CANDIDATS) {
+            int c1 = c0 + TUILE_CANDIDATS < n ? c0 + TUILE_CANDIDATS : n;
+            for (int g = g0; g < g1; g++) {
+                uint16_t *h = hist[indices[g]];
+                SignatureCode sg = sig[g];
+                for (int c = c0; c < c1; c++)
+                    h[case_signatures(sig[c], sg)]++;
+            }
+        }
+    }
+    return (uint64_t)n * (uint64_t)n;
+}
+
+// Version par lignes du cache de feedbacks
+static void histogrammes_en_cache(Solveur *sv, CacheFeedback *cache)
+{
+    for (int g = 0; g < sv->nb_possibles; g++) {
+        if (!sv->actif[g]) continue;
+        uint8_t *ligne = cache_feedback_ligne(cache, g);
+        uint16_t *h = sv->hist[g];
+        memset(h, 0, sizeof(sv->hist[0]));
+        for (int c = 0; c < sv->nb_possibles; c++)
+            if (sv->actif[c]) h[case_feedback(sv->signatures, c, g, ligne, &sv->cpt)]++;
+    }
+}
+
+static void histogrammes_depuis_actifs(Solveur *sv)
+{
+    CacheFeedback *cache = cache_utile(sv->cache, sv->restants);
+    if (cache) {
+        histogrammes_en_cache(sv, cache);
+        return;
+    }
+    sv->cpt.feedbacks += histogrammes_tuiles(sv->signatures, sv->actif,
+                                             sv->nb_possibles, sv->hist);
+}
+
+static void construire_histogrammes(Solveur *sv)
+{
+    size_t taille = (size_t)sv->nb_possibles * sizeof(sv->hist[0]);
+    if (sv->restants != sv->nb_possibles) {
+        histogrammes_depuis_actifs(sv);
+    } else {
+        pthread_mutex_lock(&verrou_initiaux);
+        uint16_t (*h)[25] = hist_initiaux[sv->cle_config];
+        if (!h) {
+            histogrammes_depuis_actifs(sv);
+            h = malloc(taille);
+            if (h) memcpy(h, sv->hist, taille);
+            hist_initiaux[sv->cle_config] = h;
+        } else {
+            memcpy(sv->hist, h, taille);
+            sv->cpt.cache_hits += (uint64_t)sv->nb_possibles * (uint64_t)sv->nb_possibles;
+        }
+        pthread_mutex_unlock(&verrou_initiaux);
+    }
+    sv->cpt.partitions += (uint64_t)sv->restants;
+    sv->hist_valide = true;
+}
+
+// Même règle que choose_next_guess : plus petite pire case, puis plus petit indice
+static void choisir_par_histogrammes(Solveur *sv, char guess_out[CODE_LEN])
+{
+    if (!sv->hist_valide) construire_histogrammes(sv);
+
+    int best_score = 999999, best_index = -1;
+    for (int g = 0; g < sv->nb_possibles; g++) {
+        if (!sv->actif[g]) continue;
+        int worst = 0;
+        for (int k = 0; k < 25; k++)
+            if (sv->hist[g][k] > worst) worst = sv->hist[g][k];
+        if (worst < best_score) {
+            best_score = worst;
+            best_index = g;
+        }
+    }
+    if (best_index < 0) best_index = 0;
+    memcpy(guess_out, sv->possibles[best_index], CODE_LEN);
+}
+
+static int filtrer_histogrammes(Solveur *sv, const char guess[CODE_LEN],
+                                int noirs, int blancs)
+{
+    static _Thread_local int elimines[SOLVEUR_MAX_CODES];
+    int nb_elim = 0, restants = 0;
+    // Indice de la proposition : sa ligne du cache sert au filtrage
+    int g0 = code_rang(code_compacter(guess), sv->couleurs, sv->repetitions);
+    SignatureCode sg = { 0, 0 };
+    bool signee = signature_code(guess, &sg);
+    CacheFeedback *cache = cache_utile(sv->cache, sv->restants);
+    uint8_t *ligne0 = cache && g0 >= 0 ? cache_feedback_ligne(cache, g0) : NULL;
+    for (int c = 0; c < sv->nb_possibles; c++) {
+        if (!sv->actif[c]) continue;
+        int k;
+        if (g0 >= 0) {
+            k = case_feedback(sv->signatures, c, g0, ligne0, &sv->cpt);
+        } else {
+            // Hors de l'espace (répétition) ; hors palette, rien ne correspond
+            k = signee ? case_signatures(sv->signatures[c], sg) : -1;
+            sv->cpt.feedbacks++;
+        }
+        if (k == noirs * 5 + blancs) {
+            restants++;
+        } else {
+            sv->actif[c] = false;
+            elimines[nb_elim++] = c;
+        }
+    }
+
+    sv->restants = restants;
+    if (nb_elim >= restants) {
+        histogrammes_depuis_actifs(sv);
+        sv->cpt.reconstructions++;
+        return restants;
+    }
+    cache = cache_utile(sv->cache, restants);
+    for (int g = 0; g < sv->nb_possibles; g++) {
+        if (!sv->actif[g]) continue;
+        uint8_t *ligne = cache ? cache_feedback_ligne(cache, g) : NULL;
+        for (int k = 0; k < nb_elim; k++)
+            sv->hist[g][case_feedback(sv->signatures, elimines[k], g, ligne, &sv->cpt)]--;
+    }
+    sv->cpt.majs_incrementales++;
+    return restants;
+}
+
+/* ============================================================
+   API publique
+   ============================================================ */
+
+Solveur *solveur_creer(const GameConfig *cfg)
+{
+    int n = nombre_codes(cfg->color_count, cfg->allow_repetition);
+    if (n <= 0) return NULL;
+    // Tableaux rangés par alignement décroissant
+    Solveur *sv = malloc(sizeof(*sv) + (size_t)n * (sizeof(SignatureCode)
+                                                    + sizeof(uint16_t) + CODE_LEN + 2));
+    if (!sv) return NULL;
+    sv->signatures = (SignatureCode *)(sv + 1);
+    sv->scores = (uint16_t *)(sv->signatures + n);
+    sv->possibles = (char (*)[CODE_LEN])(sv->scores + n);
+    sv->actif = (bool *)(sv->possibles + n);
+    sv->partition = (uint8_t *)(sv->actif + n);
+    sv->couleurs = cfg->color_count;
+    sv->repetitions = cfg->allow_repetition;
+    sv->mode = SOLVEUR_RECALCUL;
+    sv->cle_config = (cfg->color_count - MIN_COLORS) * 2 + (cfg->allow_repetition ? 1 : 0);
+    sv->hist = NULL;
+    sv->hist_valide = false;
+    sv->cache = NULL;
+    sv->nb_possibles = generate_all_codes(sv->possibles, cfg);
+    signer_codes(sv->possibles, sv->nb_possibles, sv->signatures);
+    for (int i = 0; i < sv->nb_possibles; i++)
+        sv->actif[i] = true;
+    sv->restants = sv->nb_possibles;
+    memset(sv->scores, 0, (size_t)n * sizeof(sv->scores[0]));
+    sv->partition_valide = false;
+    memset(&sv->cpt, 0, sizeof(sv->cpt));
+    return sv;
+}
+
+void solveur_detruire(Solveur *sv)
+{
+    if (sv) free(sv->hist);
+    free(sv);
+}
+
+bool solveur_choisir_mode(Solveur *sv, ModeSolveur mode)
+{
+    if (mode == SOLVEUR_INCREMENTAL && !sv->hist) {
+        sv->hist = malloc((size_t)sv->nb_possibles * sizeof(sv->hist[0]));
+        if (!sv->hist) return false;
+    }
+    sv->mode = mode;
+    sv->hist_valide = false;
+    return true;
+}
+
+bool solveur_utiliser_cache(Solveur *sv, CacheFeedback *cache)
+{
+    InfosCache infos;
+    sv->cache = NULL;
+    if (!cache) return true;
+    cache_feedback_infos(cache, &infos);
+    if (infos.nb_codes != sv->nb_possibles) return false;
+    sv->cache = cache;
+    sv->evictions_depart = infos.evictions;
+    return true;
+}
+
+// Émet un événement de trace avec l'écart des compteurs depuis « avant »
+static void tracer(const Solveur *sv, const char *nom, uint64_t debut,
+                   uint64_t duree, const CompteursSolveur *avant, int restants_avant)
+{
+    TraceArg args[] = {
+        { "coup",       sv->cpt.coups },
+        { "avant",      restants_avant },
+        { "apres",      sv->restants },
+        { "feedbacks",  (long long)(sv->cpt.feedbacks - avant->feedbacks) },
+        { "partitions", (long long)(sv->cpt.partitions - avant->partitions) },
+        { "cache_hits", (long long)(sv->cpt.cache_hits - avant->cache_hits) },
+        { "coupees",    (long long)(sv->cpt.evaluations_coupees - avant->evaluations_coupees) },
+        { "evites",     (long long)(sv->cpt.feedbacks_evites - avant->feedbacks_evites) },
+        { "reutilises", (long long)(sv->cpt.filtrages_reutilises - avant->filtrages_reutilises) },
+        { "majs",       (long long)(sv->cpt.majs_incrementales - avant->majs_incrementales) },
+        { "reconstructions", (long long)(sv->cpt.reconstructions - avant->reconstructions) },
+    };
+    trace_evenement(nom, debut, duree, args, (int)(sizeof(args) / sizeof(args[0])));
+}
+
+void solveur_proposer(Solveur *sv, char guess_out[CODE_LEN])
+{
+    CompteursSolveur avant = sv->cpt;
+    uint64_t t0 = horloge_ns();
+    if (sv->mode == SOLVEUR_INCREMENTAL) {
+        choisir_par_histogrammes(sv, guess_out);
+        sv->partition_valide = false;
+    } else {
+        sv->partition_valide = choose_next_guess(guess_out, sv->possibles,
+                                                 sv->signatures, sv->actif,
+                                                 sv->nb_possibles, sv->scores,
+                                                 sv->partition, sv->cache, &sv->cpt);
+    }
+    memcpy(sv->proposition, guess_out, CODE_LEN);
+    uint64_t duree = horloge_ns() - t0;
+
+    sv->cpt.ns_choix += duree;
+    sv->cpt.coups++;
+    if (trace_active())
+        tracer(sv, "choix", t0, duree, &avant, sv->restants);
+}
+
+int solveur_filtrer(Solveur *sv, const char guess[CODE_LEN],
+                    int noirs, int blancs)
+{
+    CompteursSolveur avant = sv->cpt;
+    int restants_avant = sv->restants;
+    uint64_t t0 = horloge_ns();
+    if (sv->mode == SOLVEUR_INCREMENTAL && sv->hist_valide) {
+        sv->restants = filtrer_histogrammes(sv, guess, noirs, blancs);
+    } else if (sv->partition_valide
+               && memcmp(guess, sv->proposition, CODE_LEN) == 0) {
+        // Le feedback de la proposition faite est déjà connu pour chaque actif
+        sv->restants = filtrer_par_partition(sv->actif, sv->nb_possibles,
+                                             sv->partition, noirs * 5 + blancs);
+        sv->cpt.filtrages_reutilises++;
+    } else {
+        sv->restants = filter_possibilities(sv->signatures, sv->actif,
+                                            sv->nb_possibles, guess, noirs, blancs,
+                                            &sv->cpt);
+    }
+    sv->partition_valide = false;
+    uint64_t duree = horloge_ns() - t0;
+
+    sv->cpt.ns_filtre += duree;
+    if (trace_active())
+        tracer(sv, "filtre", t0, duree, &avant, restants_avant);
+    return sv->restants;
+}
+
+int solveur_appliquer_historique(Solveur *sv, const char propositions[][CODE_LEN],
+                                 const int noirs[], const int blancs[], int nb)
+{
+    CompteursSolveur avant = sv->cpt;
+    int restants_avant = sv->restants;
+    uint64_t t0 = horloge_ns();
+    SignatureCode sig[256];
+    uint8_t cases[256];
+    if (nb > 256) nb = 256;
+    for (int j = 0; j < nb; j++) {
+        // Une proposition hors palette ne correspond à aucun code
+        cases[j] = signature_code(propositions[j], &sig[j])
+                   ? (uint8_t)(noirs[j] * 5 + blancs[j]) : 0xFF;
+    }
+    sv->restants = filtrer_contraintes(sv->signatures, sv->actif, sv->nb_possibles,
+                                       sig, cases, nb, &sv->cpt);
+    sv->partition_valide = false;
+    sv->hist_valide = false;
+    uint64_t duree = horloge_ns() - t0;
+
+    sv->cpt.ns_filtre += duree;
+    if (trace_active())
+        tracer(sv, "historique", t0, duree, &avant, restants_avant);
+    return sv->restants;
+}
+
+int solveur_restants(const Solveur *sv) { return sv->restants; }
+int solveur_taille_initiale(const Solveur *sv) { return sv->nb_possibles; }
+
+bool solveur_exemple(const Solveur *sv, char code[CODE_LEN])
+{
+    for (int i = 0; i < sv->nb_possibles; i++) {
+        if (sv->actif[i]) {
+            memcpy(code, sv->possibles[i], CODE_LEN);
+            return true;
+        }
+    }
+    return false;
+}
+
+void solveur_compteurs(const Solveur *sv, CompteursSolveur *out)
+{
+    *out = sv->cpt;
+    if (sv->cache) {
+        InfosCache infos;
+        cache_feedback_infos(sv->cache, &infos);
+        out->lignes_evincees = infos.evictions - sv->evictions_depart;
+    }
+}
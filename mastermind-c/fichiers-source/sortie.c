@@ -0,0 +1,52 @@
+#include <stdarg.h>
+#include "sortie.h"
+#include "couleurs.h"
+
+static bool muet_global = false;
+
+void sortie_rendre_muette(bool muet) {
+    muet_global = muet;
+}
+
+void sortie_init(Sortie *o, FILE *f) {
+    o->f = f;
+    o->muet = muet_global;
+    o->n = 0;
+}
+
+// Une seule écriture (un verrou, un appel système) pour tout le tour
+void sortie_vider(Sortie *o) {
+    if (o->n && !o->muet) {
+        fwrite(o->buf, 1, o->n, o->f);
+        fflush(o->f);
+    }
+    o->n = 0;
+}
+
+// Les parenthèses protègent les définitions des macros de SORTIE_MUETTE
+void (sortie_printf)(Sortie *o, const char *fmt, ...) {
+    if (o->muet) return;
+    va_list ap;
+    va_start(ap, fmt);
+    int k = vsnprintf(o->buf + o->n, sizeof(o->buf) - o->n, fmt, ap);
+    va_end(ap);
+    if (k < 0) return;
+    if ((size_t)k < sizeof(o->buf) - o->n) {
+        o->n += (size_t)k;
+        return;
+    }
+    // Pas la place : on vide puis on reformate (directement si trop long)
+    sortie_vider(o);
+    va_start(ap, fmt);
+    if ((size_t)k < sizeof(o->buf))
+        o->n = (size_t)vsnprintf(o->buf, sizeof(o->buf), fmt, ap);
+    else
+        vfprintf(o->f, fmt, ap);
+    va_end(ap);
+}
+
+void (sortie_palette)(Sortie *o, int color_count) {
+    sortie_printf(o, "Palette:\n");
+    for (int i=0;i<color_count;i++)
+        sortie_printf(o, "  %c = %s\n", GLOBAL_COLOR_SET[i], GLOBAL_COLOR_NAMES[i]);
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <unistd.h>
 #include "statistiques.h"
 
 bool charger_stats(Stats *st, const char *chemin) {
@@ -18,13 +19,18 @@ bool charger_stats(Stats *st, const char *chemin) {
     return true;
 }
 
+// Ecriture dans un fichier temporaire puis rename : un lecteur ou un autre
+// processus ne voit jamais un fichier a moitie ecrit.
 bool sauvegarder_stats(const Stats *st, const char *chemin) {
-    FILE *f = fopen(chemin, "w");
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", chemin, (long)getpid());
+    FILE *f = fopen(tmp, "w");
     if (!f) return false;
     fprintf(f, "%lu %lu %lu %.6f\n",
             st->games_played, st->games_won,
             st->total_tries, st->total_time);
-    fclose(f);
+    if (fclose(f) != 0) { remove(tmp); return false; }
+    if (rename(tmp, chemin) != 0) { remove(tmp); return false; }
     return true;
 }
 
@@ -41,7 +47,11 @@ void afficher_stats(const Stats *st) {
     double avg_time = (st->games_played>0)
         ? (st->total_time / (double)st->games_played)
         : 0.0;
+    double avg_move = (st->total_tries>0)
+        ? (st->total_time / (double)st->total_tries)
+        : 0.0;
     printf("- Taux de victoire: %.1f%%\n", win_rate);
     printf("- Tentatives moyennes: %.2f\n", avg_tries);
-    printf("- Temps moyen par partie: %.2fs\n\n", avg_time);
+    printf("- Temps moyen par partie: %.3fs\n", avg_time);
+    printf("- Temps moyen par tentative: %.3fms\n\n", avg_move * 1000.0);
 }
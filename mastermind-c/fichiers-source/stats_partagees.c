@@ -0,0 +1,144 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "stats_partagees.h"
+#include "statistiques.h"
+
+// Nom du segment : hachage FNV-1a du chemin absolu du fichier de stats,
+// pour que deux processus lancés depuis le même dossier se retrouvent.
+static void nom_segment(const char *chemin, char nom[64]) {
+    char absolu[PATH_MAX];
+    if (chemin[0] != '/' && getcwd(absolu, sizeof(absolu)) != NULL) {
+        size_t n = strlen(absolu);
+        snprintf(absolu + n, sizeof(absolu) - n, "/%s", chemin);
+    } else {
+        snprintf(absolu, sizeof(absolu), "%s", chemin);
+    }
+    uint64_t h = 1469598103934665603ULL;
+    for (const char *p=absolu; *p; ++p) {
+        h ^= (unsigned char)*p;
+        h *= 1099511628211ULL;
+    }
+    snprintf(nom, 64, "/mastermind-stats-%016llx", (unsigned long long)h);
+}
+
+// Verrou de garde, rendu en fermant le descripteur ; -1 si indisponible
+static int prendre_garde(const char *chemin) {
+    char nom[PATH_MAX];
+    snprintf(nom, sizeof(nom), "%s.verrou", chemin);
+    int fd = open(nom, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) return -1;
+    while (flock(fd, LOCK_EX) != 0) {
+        if (errno != EINTR) { close(fd); return -1; }
+    }
+    return fd;
+}
+
+static bool segment_valide(const SegmentStats *seg) {
+    return atomic_load_explicit(&seg->pret, memory_order_acquire) == 1
+        && seg->magic == STATS_SEG_MAGIC
+        && seg->version == STATS_SEG_VERSION
+        && seg->taille == sizeof(SegmentStats);
+}
+
+bool stats_partagees_ouvrir(StatsPartagees *sp, const char *chemin) {
+    memset(sp, 0, sizeof(*sp));
+    sp->fd = -1;
+    sp->chemin = chemin;
+    nom_segment(chemin, sp->nom);
+
+    int garde = prendre_garde(chemin);
+    if (garde < 0) return false;
+    int fd = shm_open(sp->nom, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) { close(garde); return false; }
+
+    // Personne d'autre d'attaché : segment neuf, ou laissé par des
+    // processus morts (il garde alors leurs derniers totaux publiés,
+    // plus récents que le fichier)
+    bool seul = flock(fd, LOCK_EX | LOCK_NB) == 0;
+    struct stat st;
+    void *m = MAP_FAILED;
+    if (fstat(fd, &st) == 0
+        && ((size_t)st.st_size == sizeof(SegmentStats)
+            || (seul && ftruncate(fd, sizeof(SegmentStats)) == 0)))
+        m = mmap(NULL, sizeof(SegmentStats), PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd, 0);
+    if (m == MAP_FAILED) { close(fd); close(garde); return false; }
+    SegmentStats *seg = m;
+
+    if (!segment_valide(seg)) {
+        if (!seul) {                // autre version en service
+            munmap(m, sizeof(SegmentStats));
+            close(fd);
+            close(garde);
+            return false;
+        }
+        Stats initial;
+        charger_stats(&initial, chemin);
+        seg->magic = STATS_SEG_MAGIC;
+        seg->version = STATS_SEG_VERSION;
+        seg->taille = (uint32_t)sizeof(SegmentStats);
+        atomic_store(&seg->games_played, initial.games_played);
+        atomic_store(&seg->games_won, initial.games_won);
+        atomic_store(&seg->total_tries, initial.total_tries);
+        atomic_store(&seg->total_time_ns,
+                     (unsigned long long)(initial.total_time * 1e9));
+        atomic_store_explicit(&seg->pret, 1, memory_order_release);
+    }
+
+    // Présence : verrou partagé tenu jusqu'à la fermeture
+    flock(fd, LOCK_SH);
+    close(garde);
+    sp->fd = fd;
+    sp->seg = seg;
+    return true;
+}
+
+void stats_partagees_ajouter(StatsPartagees *sp, const Stats *delta) {
+    SegmentStats *seg = sp->seg;
+    if (delta->games_played)
+        atomic_fetch_add_explicit(&seg->games_played, delta->games_played, memory_order_relaxed);
+    if (delta->games_won)
+        atomic_fetch_add_explicit(&seg->games_won, delta->games_won, memory_order_relaxed);
+    if (delta->total_tries)
+        atomic_fetch_add_explicit(&seg->total_tries, delta->total_tries, memory_order_relaxed);
+    if (delta->total_time > 0.0)
+        atomic_fetch_add_explicit(&seg->total_time_ns,
+                                  (unsigned long long)(delta->total_time * 1e9),
+                                  memory_order_relaxed);
+}
+
+void stats_partagees_lire(const StatsPartagees *sp, Stats *out) {
+    SegmentStats *seg = sp->seg;
+    out->games_played = atomic_load_explicit(&seg->games_played, memory_order_relaxed);
+    out->games_won    = atomic_load_explicit(&seg->games_won, memory_order_relaxed);
+    out->total_tries  = atomic_load_explicit(&seg->total_tries, memory_order_relaxed);
+    out->total_time   = (double)atomic_load_explicit(&seg->total_time_ns,
+                                                     memory_order_relaxed) / 1e9;
+}
+
+// Écrit les totaux sur disque puis se détache ; le dernier processus
+// détaché supprime le segment (il sera recréé depuis le fichier).
+bool stats_partagees_fermer(StatsPartagees *sp) {
+    if (!sp->seg) return false;
+    int garde = prendre_garde(sp->chemin);
+    Stats total;
+    stats_partagees_lire(sp, &total);
+    bool ok = sauvegarder_stats(&total, sp->chemin);
+    // Le passage en exclusif n'aboutit que si plus personne n'est attaché
+    if (garde >= 0 && flock(sp->fd, LOCK_EX | LOCK_NB) == 0)
+        shm_unlink(sp->nom);
+    munmap(sp->seg, sizeof(SegmentStats));
+    close(sp->fd);
+    if (garde >= 0) close(garde);
+    sp->seg = NULL;
+    sp->fd = -1;
+    return ok;
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "trace.h"
+#include "horloge.h"
+
+/* ============================================================
+   Trace JSON : un seul fichier par processus, écritures sérialisées
+   ============================================================ */
+
+static FILE *sortie = NULL;
+static atomic_bool active = false;   // lu sans verrou par trace_active
+static bool format_chrome = false;
+static bool premier = true;
+static uint64_t origine_ns = 0;
+static pthread_mutex_t verrou = PTHREAD_MUTEX_INITIALIZER;
+
+bool trace_ouvrir(const char *chemin)
+{
+    size_t n = strlen(chemin);
+    FILE *f = fopen(chemin, "w");
+    if (!f) return false;
+
+    pthread_mutex_lock(&verrou);
+    if (sortie) fclose(sortie);
+    sortie = f;
+    format_chrome = n >= 5 && strcmp(chemin + n - 5, ".json") == 0;
+    premier = true;
+    origine_ns = horloge_ns();
+    // Tableau d'événements : le visualiseur accepte un "]" manquant si
+    // le processus s'arrête sans passer par trace_fermer
+    if (format_chrome) fputs("[\n", sortie);
+    atomic_store(&active, true);
+    pthread_mutex_unlock(&verrou);
+    return true;
+}
+
+bool trace_active(void)
+{
+    return atomic_load_explicit(&active, memory_order_relaxed);
+}
+
+void trace_evenement(const char *nom, uint64_t debut_ns, uint64_t duree_ns,
+                     const TraceArg *args, int nb_args)
+{
+    long tid = (long)syscall(SYS_gettid);
+
+    pthread_mutex_lock(&verrou);
+    if (!sortie) {
+        pthread_mutex_unlock(&verrou);
+        return;
+    }
+    uint64_t rel = debut_ns >= origine_ns ? debut_ns - origine_ns : 0;
+
+    if (format_chrome) {
+        // Horodatages en microsecondes, avec la précision de la nanoseconde
+        fprintf(sortie, "%s{\"name\":\"%s\",\"cat\":\"solveur\",\"ph\":\"X\","
+                "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%ld,\"args\":{",
+                premier ? "" : ",\n", nom, (double)rel / 1e3,
+                (double)duree_ns / 1e3, (long)getpid(), tid);
+        for (int i = 0; i < nb_args; i++)
+            fprintf(sortie, "%s\"%s\":%lld", i ? "," : "",
+                    args[i].cle, args[i].valeur);
+        fputs("}}", sortie);
+    } else {
+        fprintf(sortie, "{\"evenement\":\"%s\",\"debut_ns\":%llu,"
+                "\"duree_ns\":%llu,\"tid\":%ld",
+                nom, (unsigned long long)rel,
+                (unsigned long long)duree_ns, tid);
+        for (int i = 0; i < nb_args; i++)
+            fprintf(sortie, ",\"%s\":%lld", args[i].cle, args[i].valeur);
+        fputs("}\n", sortie);
+    }
+    premier = false;
+    pthread_mutex_unlock(&verrou);
+}
+
+void trace_fermer(void)
+{
+    pthread_mutex_lock(&verrou);
+    atomic_store(&active, false);
+    if (sortie) {
+        if (format_chrome) fputs("\n]\n", sortie);
+        fclose(sortie);
+        sortie = NULL;
+    }
+    pthread_mutex_unlock(&verrou);
+}
@@ -1,10 +1,85 @@
+#include <errno.h>
+#include <poll.h>
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 #include "utils.h"
 
+/* Toute la lecture clavier passe par ce tampon sur le descripteur 0
+   (et non par fgets) pour pouvoir attendre avec poll ; l'échéance elle-même
+   est tenue par chronometre.c, ce fichier n'a pas besoin d'horloge. */
+static char tampon[4096];
+static size_t debut, fin;
+static bool jeter_ligne;    // reste d'une ligne abandonnée à l'échéance
+
+// Cherche une ligne complète dans le tampon ; la copie (tronquée) si trouvée
+static bool extraire_ligne(char *buffer, size_t buflen) {
+    for (;;) {
+        char *nl = memchr(tampon + debut, '\n', fin - debut);
+        if (!nl) return false;
+        size_t n = (size_t)(nl - (tampon + debut));
+        bool jeter = jeter_ligne;
+        jeter_ligne = false;
+        if (!jeter) {
+            size_t k = n < buflen - 1 ? n : buflen - 1;
+            memcpy(buffer, tampon + debut, k);
+            buffer[k] = '\0';
+        }
+        debut += n + 1;
+        if (!jeter) return true;
+    }
+}
+
+ResultatLecture lire_ligne_attente(char *buffer, size_t buflen, int attente_ms) {
+    if (buflen == 0) return LECTURE_FIN;
+    fflush(stdout);
+    for (;;) {
+        if (extraire_ligne(buffer, buflen)) return LECTURE_OK;
+
+        if (debut > 0) {
+            memmove(tampon, tampon + debut, fin - debut);
+            fin -= debut;
+            debut = 0;
+        }
+        if (fin == sizeof(tampon)) {
+            // Ligne plus longue que le tampon : on la rend tronquée
+            size_t k = fin < buflen - 1 ? fin : buflen - 1;
+            memcpy(buffer, tampon, k);
+            buffer[k] = '\0';
+            fin = 0;
+            jeter_ligne = true;
+            return LECTURE_OK;
+        }
+
+        struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+        int r = poll(&pfd, 1, attente_ms);
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0) return LECTURE_FIN;
+        if (r == 0) return LECTURE_DELAI;
+
+        ssize_t n = read(STDIN_FILENO, tampon + fin, sizeof(tampon) - fin);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            // Fin de l'entrée : une dernière ligne sans '\n' reste valable
+            if (fin > 0 && !jeter_ligne) {
+                size_t k = fin < buflen - 1 ? fin : buflen - 1;
+                memcpy(buffer, tampon, k);
+                buffer[k] = '\0';
+                fin = 0;
+                return LECTURE_OK;
+            }
+            return LECTURE_FIN;
+        }
+        fin += (size_t)n;
+        // L'appelant chronométré recalcule l'attente restante
+        if (attente_ms >= 0 && !memchr(tampon, '\n', fin)) return LECTURE_DELAI;
+    }
+}
+
+void abandonner_ligne(void) {
+    if (fin > debut) { debut = fin = 0; jeter_ligne = true; }
+}
+
 bool lire_ligne(char *buffer, size_t buflen) {
-    if (fgets(buffer, (int)buflen, stdin) == NULL) return false;
-    size_t n = strlen(buffer);
-    if (n>0 && buffer[n-1]=='\n') buffer[n-1]='\0';
-    return true;
+    return lire_ligne_attente(buffer, buflen, -1) == LECTURE_OK;
 }
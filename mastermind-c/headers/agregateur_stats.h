@@ -0,0 +1,48 @@
+#ifndef AGREGATEUR_STATS_H
+#define AGREGATEUR_STATS_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "types.h"
+#include "stats_partagees.h"
+
+#define STATS_NB_FRAGMENTS 16
+
+// Compteurs d'un fragment : chaque thread écrit dans le sien,
+// aligné sur une ligne de cache pour éviter le faux partage.
+typedef struct {
+    _Alignas(64) atomic_ulong games_played;
+    atomic_ulong games_won;
+    atomic_ulong total_tries;
+    atomic_ullong total_time_ns;
+} FragmentStats;
+
+typedef struct {
+    Stats base;                      // valeurs lues au démarrage
+    FragmentStats fragments[STATS_NB_FRAGMENTS];
+    atomic_ulong version;            // incrémentée à chaque partie enregistrée
+    unsigned long version_sauvee;    // dernière version écrite sur disque
+    const char *chemin;
+    int intervalle_ms;               // 0 = pas de thread de sauvegarde
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool arret;
+    bool thread_actif;
+    // Mode multi-processus : les deltas des fragments sont publiés dans
+    // le segment partagé, qui fait foi pour la lecture et la sauvegarde.
+    bool partage;
+    StatsPartagees segment;
+    Stats publie;                    // somme des fragments déjà publiée
+} AgregateurStats;
+
+bool agregateur_init(AgregateurStats *ag, const char *chemin,
+                     int intervalle_ms, bool partage);
+void agregateur_enregistrer(AgregateurStats *ag, bool gagne,
+                            int tentatives, double duree_sec);
+void agregateur_lire(AgregateurStats *ag, Stats *out);
+bool agregateur_persister(AgregateurStats *ag);
+void agregateur_fermer(AgregateurStats *ag);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef ALEA_H
+#define ALEA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "types.h"
+
+// Générateur xoshiro256** : un état par session, sans variable globale
+typedef struct {
+    uint64_t s[4];
+} Alea;
+
+void alea_init(Alea *a, uint64_t graine);
+uint64_t alea_suivant(Alea *a);
+uint32_t alea_borne(Alea *a, uint32_t n);   // uniforme dans [0, n), sans biais
+uint64_t alea_graine_systeme(void);
+
+void generer_secret(char secret[CODE_LEN], int color_count,
+                    bool allow_repetition, Alea *a);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef CACHE_FEEDBACK_H
+#define CACHE_FEEDBACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "types.h"
+
+/* Cache paresseux des feedbacks du solveur, borné en mémoire.
+   Une ligne par proposition, créée à sa première évaluation et remplie
+   au fil des comparaisons ; une entrée par code, sur 4 bits : avec 4
+   positions seules 14 cases noirs*5+blancs sont possibles, la valeur 15
+   marque une entrée pas encore calculée. Quand le plafond est atteint, la
+   ligne la moins récemment utilisée (approximation « horloge ») est
+   recyclée ; si le plafond ne tient pas une seule ligne, le cache ne
+   garde rien et l'appelant calcule directement. Les lignes ne dépendent
+   que de l'espace des codes : un même cache sert à toutes les parties
+   d'une configuration. */
+
+typedef struct CacheFeedback CacheFeedback;
+
+#define CACHE_CASE_INCONNUE 0xFF
+
+extern const uint8_t CACHE_CASE_VERS_QUARTET[25];
+extern const uint8_t CACHE_QUARTET_VERS_CASE[16];
+
+CacheFeedback *cache_feedback_creer(int nb_codes, size_t plafond_octets);
+void cache_feedback_detruire(CacheFeedback *c);
+
+// Ligne de la proposition g (créée vide si besoin), NULL si hors budget.
+// Le pointeur reste valable jusqu'au prochain appel.
+uint8_t *cache_feedback_ligne(CacheFeedback *c, int g);
+
+// Case du code i dans la ligne, CACHE_CASE_INCONNUE si pas encore calculée
+static inline uint8_t cache_feedback_lire(const uint8_t *ligne, int i)
+{
+    return CACHE_QUARTET_VERS_CASE[(ligne[i >> 1] >> ((i & 1) * 4)) & 15];
+}
+
+static inline void cache_feedback_ecrire(uint8_t *ligne, int i, int case_fb)
+{
+    int dec = (i & 1) * 4;
+    ligne[i >> 1] = (uint8_t)((ligne[i >> 1] & ~(15 << dec))
+                              | (CACHE_CASE_VERS_QUARTET[case_fb] << dec));
+}
+
+typedef struct {
+    int nb_codes;           // taille des lignes
+    size_t plafond;         // octets de lignes autorisés
+    size_t octets;          // octets de lignes réservés
+    int capacite;           // lignes tenant sous le plafond
+    int lignes;             // lignes matérialisées
+    uint64_t evictions;     // lignes recyclées
+} InfosCache;
+
+void cache_feedback_infos(const CacheFeedback *c, InfosCache *out);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef CANDIDATS_H
+#define CANDIDATS_H
+
+#include <stdbool.h>
+#include "types.h"
+
+/* Codes encore compatibles avec l'historique d'une partie (mode aide du
+   joueur). Les survivants sont gardés tassés avec leur signature : un
+   coup ne parcourt que l'ensemble courant, jamais tout l'espace. Un
+   bitmap indexé par rang (rang.h) dit en O(1) si un code en fait partie. */
+
+typedef struct Candidats Candidats;
+
+// Ensemble initial filtré par un historique éventuel (nb peut valoir 0)
+Candidats *candidats_creer(const GameConfig *cfg, const char propositions[][CODE_LEN],
+                           const int noirs[], const int blancs[], int nb);
+void candidats_detruire(Candidats *c);
+
+bool candidats_contient(const Candidats *c, const char code[CODE_LEN]);
+// Garde les codes qui donnent ce feedback à la proposition ; renvoie leur nombre
+int candidats_filtrer(Candidats *c, const char guess[CODE_LEN], int noirs, int blancs);
+int candidats_nombre(const Candidats *c);
+
+#endif
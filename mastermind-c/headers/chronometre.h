@@ -1,11 +1,9 @@
 #ifndef CHRONOMETRE_H
 #define CHRONOMETRE_H
 
-#include <stdbool.h>
-#include "types.h"
+#include <stddef.h>
+#include "utils.h"
 
-bool saisie_minutee(char out_code[CODE_LEN],
-                    int color_count, bool allow_repetition,
-                    int time_limit_sec);
+ResultatLecture saisie_minutee(char *ligne, size_t taille, int time_limit_sec);
 
 #endif
@@ -1,10 +1,52 @@
 #ifndef FEEDBACK_H
 #define FEEDBACK_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "types.h"
 
 void calculer_feedback(const char secret[CODE_LEN],
                        const char guess[CODE_LEN],
                        int *noirs, int *blancs);
 
+/* Signature d'un code, à calculer une fois par code : nombre de pions de
+   chaque couleur (un quartet par couleur) et couleur de chaque position
+   (un bit parmi 8 par position). Les noirs sont le popcount du ET des
+   positions ; noirs + blancs, la somme des minima quartet par quartet des
+   comptes (SWAR, sans boucle ni tableau). */
+typedef struct {
+    uint32_t comptes;
+    uint32_t positions;
+} SignatureCode;
+
+// Faux si une lettre n'est pas une couleur de GLOBAL_COLOR_SET (majuscule)
+bool signature_code(const char code[CODE_LEN], SignatureCode *out);
+
+// Pions communs toutes positions confondues : somme des min(a, b) par quartet
+static inline int signatures_communs(uint32_t a, uint32_t b)
+{
+    // Comptes <= 4 : le bit haut de chaque quartet est libre et sert de
+    // retenue ; il reste posé là où a >= b
+    const uint32_t HAUTS = 0x88888888u;
+    uint32_t a_sup = (((a | HAUTS) - b) & HAUTS) >> 3;
+    uint32_t masque = a_sup * 15u;
+    uint32_t minima = (b & masque) | (a & ~masque);
+    return (int)((minima * 0x11111111u) >> 28);
+}
+
+static inline void feedback_signatures(SignatureCode a, SignatureCode b,
+                                       int *noirs, int *blancs)
+{
+    int n = __builtin_popcount(a.positions & b.positions);
+    *noirs = n;
+    *blancs = signatures_communs(a.comptes, b.comptes) - n;
+}
+
+// Case noirs*5+blancs, telle que l'indexent les partitions du solveur
+static inline int case_signatures(SignatureCode a, SignatureCode b)
+{
+    int n = __builtin_popcount(a.positions & b.positions);
+    return n * 4 + signatures_communs(a.comptes, b.comptes);
+}
+
 #endif
@@ -0,0 +1,10 @@
+#ifndef HORLOGE_H
+#define HORLOGE_H
+
+#include <stdint.h>
+
+// Horloge monotone (CLOCK_MONOTONIC) : insensible aux changements d'heure
+uint64_t horloge_ns(void);
+uint64_t horloge_ms(void);
+
+#endif
@@ -1,8 +1,19 @@
 #ifndef IA_H
 #define IA_H
 
+#include <stddef.h>
 #include "types.h"
+#include "agregateur_stats.h"
 
-void jouer_ia(GameConfig cfg, Stats *st);
+// Plafond du cache de feedbacks du solveur de l'IA, gardé d'une partie à
+// l'autre (1 Mo suffit pour toute la table 6 couleurs avec répétitions).
+// 0 par défaut : avec les signatures, un feedback coûte à peine plus
+// qu'une lecture du cache et le mode incrémental n'y gagne plus.
+#define IA_PLAFOND_CACHE_DEFAUT ((size_t)0)
+
+void ia_fixer_plafond_cache(size_t octets);
+void jouer_ia(GameConfig cfg, AgregateurStats *st);
+// L'IA termine la partie de save.txt, candidats filtrés par son historique
+void ia_reprendre_partie(AgregateurStats *st);
 
 #endif
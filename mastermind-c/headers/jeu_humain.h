@@ -1,8 +1,14 @@
 #ifndef JEU_HUMAIN_H
 #define JEU_HUMAIN_H
 
+#include <stdbool.h>
 #include "types.h"
+#include "agregateur_stats.h"
 
-void jouer_humain(GameConfig cfg, Stats *st);
+void jouer_humain(GameConfig cfg, AgregateurStats *st);
+void reprendre_partie(AgregateurStats *st);
+
+// Affiche le nombre de codes encore possibles après chaque coup
+void jeu_humain_fixer_aide(bool active);
 
 #endif
@@ -0,0 +1,30 @@
+#ifndef LOT_H
+#define LOT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "types.h"
+
+/* Mode lot : parties jouées sans interaction à partir d'un flux.
+
+   Une partie par ligne, jetons séparés par des espaces :
+       RGBY RGBO GBYR ...       secret puis propositions
+       @42 RGBO GBYR ...        secret tiré de la graine 42 (comme session_creer)
+   Les lignes vides et celles qui commencent par '#' sont ignorées.
+
+   Une ligne de résultat par partie :
+       <état> <tentatives> <feedbacks>
+   état : G gagnée, P perdue, E encore en cours, ! ligne invalide ;
+   feedbacks : deux chiffres (noirs, blancs) par proposition acceptée,
+   "xx" pour une proposition refusée. Exemple : "G 3 102140". */
+
+typedef struct {
+    unsigned long parties;
+    unsigned long coups;
+    unsigned long invalides;    // lignes ou propositions refusées
+    double duree_sec;
+} RapportLot;
+
+bool executer_lot(FILE *entree, FILE *sortie, const GameConfig *cfg, RapportLot *r);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef MINUTEURS_H
+#define MINUTEURS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ROUE_PAS_MS     10          // résolution d'un pas
+#define ROUE_BITS        6
+#define ROUE_CASES      (1 << ROUE_BITS)
+#define ROUE_NIVEAUX     4          // 64^4 pas de 10 ms : environ 46 heures
+
+// Minuteur intrusif : à placer dans une structure dont l'adresse ne bouge
+// pas (retrouvée depuis le rappel par décalage de champ).
+typedef struct Minuteur {
+    struct Minuteur *suivant, *precedent;
+    uint64_t echeance;              // en pas
+} Minuteur;
+
+/* Roue hiérarchique : le niveau n couvre 64^(n+1) pas ; quand le niveau 0
+   fait un tour, la case courante du niveau 1 est redescendue, etc.
+   Armer et annuler sont en O(1) ; chaque minuteur redescend au plus
+   ROUE_NIVEAUX-1 fois avant de se déclencher. */
+typedef struct {
+    Minuteur cases[ROUE_NIVEAUX][ROUE_CASES];   // têtes de listes circulaires
+    uint64_t courant;               // prochain pas à traiter
+    size_t nb;
+} RoueMinuteurs;
+
+// Le rappel reçoit les minuteurs échus par lot ; il peut réarmer ou annuler
+// n'importe quel minuteur, y compris un autre du même lot.
+typedef void (*RappelMinuteur)(Minuteur *m, void *ctx);
+
+void roue_init(RoueMinuteurs *r, uint64_t maintenant_ms);
+void roue_armer(RoueMinuteurs *r, Minuteur *m, uint64_t echeance_ms);
+void roue_annuler(RoueMinuteurs *r, Minuteur *m);
+size_t roue_avancer(RoueMinuteurs *r, uint64_t maintenant_ms,
+                    RappelMinuteur rappel, void *ctx);
+// Instant (ms) où la roue a du travail ; UINT64_MAX si rien n'est armé
+uint64_t roue_prochain_reveil(const RoueMinuteurs *r);
+
+#endif
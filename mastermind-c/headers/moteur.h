@@ -0,0 +1,98 @@
+#ifndef MOTEUR_H
+#define MOTEUR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "types.h"
+#include "pool.h"
+#include "minuteurs.h"
+
+/* ============================================================
+   Moteur de jeu sans entrées/sorties console (libmastermind)
+   ============================================================ */
+
+typedef struct Session Session;
+
+typedef enum {
+    COUP_OK,        // proposition acceptée, partie toujours en cours
+    COUP_GAGNE,     // code trouvé
+    COUP_PERDU,     // dernière tentative épuisée
+    COUP_INVALIDE,  // proposition refusée (couleur, longueur, répétition)
+    COUP_TERMINE,   // la partie était déjà finie
+    COUP_HORS_DELAI // la tentative a expiré avant cette proposition
+} ResultatCoup;
+
+typedef enum {
+    PARTIE_EN_COURS,
+    PARTIE_GAGNEE,
+    PARTIE_PERDUE
+} EtatPartie;
+
+// Le secret est entièrement déterminé par la graine (voir alea.h)
+Session *session_creer(const GameConfig *cfg, uint64_t graine);
+// NULL si l'état est incohérent (secret ou coup hors configuration,
+// feedback qui ne correspond pas au secret)
+Session *session_depuis_etat(const GameState *gs);
+void session_detruire(Session *s);
+
+ResultatCoup session_proposer(Session *s, const char code[CODE_LEN],
+                              int *noirs, int *blancs);
+ResultatCoup session_proposer_texte(Session *s, const char *ligne,
+                                    int *noirs, int *blancs);
+
+// Échéances consécutives sans aucune proposition au-delà desquelles la
+// partie est perdue (joueur parti)
+#define SESSION_ECHEANCES_MAX 3
+
+// Marque la tentative en cours comme expirée (mode chronométré) : la
+// prochaine proposition est refusée sans consommer de tentative.
+void session_expirer(Session *s);
+
+// Échéances par tentative des sessions chronométrées, portées par la
+// session elle-même : la roue est réarmée à chaque proposition acceptée
+// ou tentative expirée, et libérée en fin de partie ou à la destruction.
+// Une session perdue à l'échéance n'est plus réarmée et passe au rappel,
+// qui peut la détruire.
+typedef void (*RappelPartieFinie)(Session *s, void *ctx);
+void session_armer_echeance(Session *s, RoueMinuteurs *r, uint64_t maintenant_ms);
+size_t sessions_avancer_echeances(RoueMinuteurs *r, uint64_t maintenant_ms,
+                                  RappelPartieFinie fin, void *ctx);
+
+EtatPartie session_etat(const Session *s);
+// Durées sur l'horloge monotone : par tentative (résolution µs) et totale
+uint64_t session_duree_coup_ns(const Session *s, int i);
+uint64_t session_duree_ns(const Session *s);
+const GameConfig *session_config(const Session *s);
+int session_tentatives(const Session *s);
+uint64_t session_graine(const Session *s);
+// Valeur libre de l'appelant (le serveur y range l'identifiant de session)
+uint64_t session_etiquette(const Session *s);
+void session_fixer_etiquette(Session *s, uint64_t etiquette);
+void session_coup(const Session *s, int i, char code[CODE_LEN],
+                  int *noirs, int *blancs);
+void session_secret(const Session *s, char code[CODE_LEN]);
+void session_vers_etat(const Session *s, GameState *gs);
+
+// Format texte identique à save.txt ; renvoie la longueur nécessaire
+size_t session_serialiser(const Session *s, char *buf, size_t taille);
+Session *session_deserialiser(const char *texte);
+
+// Mémoire des sessions : une classe de taille par borne de max_tries
+#define SESSION_NB_CLASSES 4
+
+typedef struct {
+    int max_tries;                  // borne haute de la classe
+    PoolStats pool;
+} ClasseSessions;
+
+typedef struct {
+    ClasseSessions classes[SESSION_NB_CLASSES];
+    unsigned long vivantes;
+    size_t octets_par_session;      // octets réservés / sessions vivantes
+    double allocations_par_sec;     // depuis la première session créée
+} MemoireSessions;
+
+void session_memoire(MemoireSessions *out);
+
+#endif
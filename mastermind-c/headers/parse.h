@@ -2,11 +2,31 @@
 #define PARSE_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "types.h"
 
+// Code compact : indice de couleur sur 3 bits par pion, pion 0 en poids faible
+typedef uint16_t CodeCompact;
+#define CODE_COMPACT_INVALIDE 0xFFFF
+
 bool caractere_couleur_valide(char c, int color_count);
 bool sans_repetition(const char code[], int len);
+// Code déjà en lettres majuscules (celles de GLOBAL_COLOR_SET)
+bool code_valide(const char code[CODE_LEN], int color_count, bool allow_repetition);
 bool parser_proposition(const char *ligne, char out_code[CODE_LEN],
                         int color_count, bool allow_repetition);
 
+// Même règles que parser_proposition, sur n octets sans copie
+bool parser_compact(const char *texte, size_t n, int color_count,
+                    bool allow_repetition, CodeCompact *out);
+// Une proposition par ligne ; une ligne refusée donne CODE_COMPACT_INVALIDE.
+// Seules les lignes complètes sont lues ; *consommes reçoit leur taille.
+size_t parser_propositions(const char *buf, size_t n, int color_count,
+                           bool allow_repetition, CodeCompact *codes,
+                           size_t max, size_t *consommes);
+
+CodeCompact code_compacter(const char code[CODE_LEN]);
+bool code_decompacter(CodeCompact v, char code[CODE_LEN]);
+
 #endif
@@ -0,0 +1,39 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#define POOL_ALIGNEMENT 64          // une ligne de cache
+#define POOL_TAILLE_SLAB (64 * 1024)
+
+typedef struct BlocLibre BlocLibre;
+
+// Allocateur d'enregistrements de taille fixe : découpe des slabs alignés
+// et réutilise les blocs libérés via une liste chaînée.
+typedef struct {
+    size_t taille;              // taille d'un enregistrement, multiple de 64
+    BlocLibre *libres;
+    char *courant;              // reste du slab en cours de découpe
+    size_t restant;
+    void **slabs;
+    size_t nb_slabs, cap_slabs;
+    unsigned long vivants;
+    unsigned long allocations;  // cumul depuis pool_init
+    pthread_mutex_t verrou;
+} Pool;
+
+typedef struct {
+    size_t taille;
+    unsigned long vivants;
+    unsigned long allocations;
+    size_t octets_reserves;     // slabs obtenus du système
+} PoolStats;
+
+void pool_init(Pool *p, size_t taille_objet);
+void *pool_allouer(Pool *p);
+void pool_liberer(Pool *p, void *obj);
+void pool_statistiques(Pool *p, PoolStats *out);
+void pool_detruire(Pool *p);
+
+#endif
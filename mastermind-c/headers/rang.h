@@ -0,0 +1,20 @@
+#ifndef RANG_H
+#define RANG_H
+
+#include <stdbool.h>
+#include "types.h"
+#include "parse.h"
+
+/* Rang dense d'un code dans l'espace d'une configuration, dans l'ordre de
+   generate_all_codes (pion 0 en poids fort) : écriture en base
+   « couleurs » avec répétitions, code de Lehmer des arrangements sans
+   (4 parmi 6 : rangs 0..359 au lieu de 0..1295). Toute structure indexée
+   par code peut ainsi être taillée à nombre_codes(). */
+
+int nombre_codes(int color_count, bool allow_repetition);
+// -1 si le code n'appartient pas à l'espace
+int code_rang(CodeCompact v, int color_count, bool allow_repetition);
+bool code_depuis_rang(int rang, int color_count, bool allow_repetition,
+                      CodeCompact *out);
+
+#endif
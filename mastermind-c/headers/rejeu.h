@@ -0,0 +1,42 @@
+#ifndef REJEU_H
+#define REJEU_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "types.h"
+#include "moteur.h"
+
+#define REJEU_FICHIER "parties.mmr"
+
+typedef enum { REJEU_HUMAIN = 0, REJEU_IA = 1 } ModeRejeu;
+
+// Une partie enregistrée : de quoi la rejouer à l'identique dans le moteur
+typedef struct {
+    ModeRejeu mode;
+    GameConfig cfg;
+    bool graine_valide;             // faux pour une partie reprise de save.txt
+    uint64_t graine;
+    char secret[CODE_LEN];
+    int nb_coups;
+    int deja_joues;                 // coups antérieurs à l'enregistrement (reprise)
+    char coups[MAX_TRIES_MAX][CODE_LEN];
+    uint8_t noirs[MAX_TRIES_MAX], blancs[MAX_TRIES_MAX];
+    uint32_t instants_ms[MAX_TRIES_MAX];    // depuis le début de l'enregistrement
+    struct timespec debut;
+} EnregistrementPartie;
+
+typedef struct {
+    unsigned long parties;
+    unsigned long coups;
+    unsigned long divergences;      // feedback, secret ou choix de l'IA différents
+    double duree_sec;
+} RapportRejeu;
+
+void rejeu_debut(EnregistrementPartie *e, const Session *s, ModeRejeu mode);
+void rejeu_noter_coup(EnregistrementPartie *e, const Session *s);
+bool rejeu_ecrire(const EnregistrementPartie *e, const char *chemin);
+bool rejeu_lire(FILE *f, EnregistrementPartie *e);
+bool rejouer_fichier(const char *chemin, RapportRejeu *r);
+
+#endif
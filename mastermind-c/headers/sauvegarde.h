@@ -2,8 +2,13 @@
 #define SAUVEGARDE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include "types.h"
 
+// Sérialisation texte (format de save.txt), sans accès fichier
+size_t formater_partie(const GameState *gs, char *buf, size_t taille);
+bool analyser_partie(GameState *gs, const char *texte);
+
 bool sauvegarder_partie(const GameState *gs, const char *chemin);
 bool charger_partie(GameState *gs, const char *chemin);
 
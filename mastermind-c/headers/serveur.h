@@ -0,0 +1,26 @@
+#ifndef SERVEUR_H
+#define SERVEUR_H
+
+#include <stdbool.h>
+
+/* Protocole ligne par ligne sur socket Unix (une réponse par requête) :
+     NEW [couleurs tentatives repetition [chrono secondes]]
+                             -> OK <id>  (chrono : secondes >= 1)
+     GUESS <id> <code>       -> FB <noirs> <blancs> <ENCOURS|GAGNE|PERDU> [secret]
+     RESUME <id>             -> STATE <id> <tentatives> <max> <ENCOURS> [code:noirs:blancs ...]
+     END <id>                -> OK <id>
+     STATS                   -> STATS <jouees> <gagnees> <tentatives> <temps>
+     MEM                     -> MEM <sessions> <octets/session> <allocs/s>
+                                    [max_tries:taille:vivantes ...]
+   Erreurs : ERR <raison>. Une session terminée est libérée aussitôt ; une
+   session sans requête (NEW, GUESS, RESUME) depuis 10 minutes est comptée
+   comme abandonnée et libérée.
+   En mode chronométré, une tentative non jouée avant l'échéance est
+   abandonnée par la roue de minuteurs : la proposition suivante reçoit
+   ERR delai et une nouvelle tentative commence. Après 3 échéances de
+   suite sans aucune requête GUESS, la partie est perdue et la session
+   libérée (ERR session ensuite). */
+
+bool lancer_serveur(const char *chemin_socket);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef SOLVEUR_H
+#define SOLVEUR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "types.h"
+#include "cache_feedback.h"
+
+// Taille maximale de l'espace des codes : MAX_COLORS ^ CODE_LEN
+#define SOLVEUR_MAX_CODES 1296
+
+typedef struct Solveur Solveur;
+
+typedef enum {
+    SOLVEUR_RECALCUL,       // partitions recalculées à chaque tour (défaut)
+    SOLVEUR_INCREMENTAL     // histogrammes de partition gardés d'un tour à l'autre
+} ModeSolveur;
+
+// Compteurs d'instrumentation, cumulés depuis solveur_creer
+typedef struct {
+    uint64_t feedbacks;     // comparaisons code/proposition effectuées
+    uint64_t partitions;    // histogrammes de feedback calculés (un par candidat)
+    uint64_t cache_hits;    // feedbacks servis sans recalcul
+    uint64_t lignes_evincees;       // lignes du cache de feedbacks recyclées
+    uint64_t evaluations_coupees;   // partitions abandonnées en cours (borne)
+    uint64_t feedbacks_evites;      // comparaisons épargnées par ces coupures
+    uint64_t filtrages_reutilises;  // filtrages faits avec la partition du choix
+    uint64_t majs_incrementales;    // tours où les histogrammes ont été décrémentés
+    uint64_t reconstructions;       // tours où ils ont été recalculés (moins cher)
+    uint64_t ns_choix;      // temps passé dans solveur_proposer
+    uint64_t ns_filtre;     // temps passé dans solveur_filtrer
+    int coups;              // propositions faites
+} CompteursSolveur;
+
+Solveur *solveur_creer(const GameConfig *cfg);
+void solveur_detruire(Solveur *sv);
+// À choisir avant la première proposition ; faux si la mémoire manque
+bool solveur_choisir_mode(Solveur *sv, ModeSolveur mode);
+// Garde les feedbacks calculés dans « cache » (cache_feedback.h), qui reste
+// à l'appelant et peut servir aux parties suivantes de même configuration
+// (pas d'accès concurrents) ; NULL le retire, faux s'il n'est pas à la
+// taille de l'espace des codes
+bool solveur_utiliser_cache(Solveur *sv, CacheFeedback *cache);
+
+void solveur_proposer(Solveur *sv, char guess_out[CODE_LEN]);
+int solveur_filtrer(Solveur *sv, const char guess[CODE_LEN],
+                    int noirs, int blancs);
+// Ne garde que les codes compatibles avec tout un historique (par exemple
+// celui d'une partie reprise), en une passe sur l'espace des codes
+int solveur_appliquer_historique(Solveur *sv, const char propositions[][CODE_LEN],
+                                 const int noirs[], const int blancs[], int nb);
+int solveur_restants(const Solveur *sv);
+int solveur_taille_initiale(const Solveur *sv);
+bool solveur_exemple(const Solveur *sv, char code[CODE_LEN]);
+void solveur_compteurs(const Solveur *sv, CompteursSolveur *out);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SOLVEUR_NOYAUX_H
+#define SOLVEUR_NOYAUX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "types.h"
+#include "solveur.h"
+#include "feedback.h"
+
+/* Noyaux de calcul du solveur, exposés pour les mesures (bench.c).
+   Le jeu passe par l'API de solveur.h. */
+
+int generate_all_codes(char codes[][CODE_LEN], const GameConfig *cfg);
+// Signature de chaque code (feedback.h), une fois pour toutes
+void signer_codes(char codes[][CODE_LEN], int nb_codes, SignatureCode signatures[]);
+bool choose_next_guess(char guess_out[CODE_LEN],
+                       char possibles[][CODE_LEN],
+                       const SignatureCode signatures[],
+                       bool actif[],
+                       int nb_possibles,
+                       uint16_t scores[],
+                       uint8_t partition[],
+                       CacheFeedback *cache,
+                       CompteursSolveur *cpt);
+int filter_possibilities(const SignatureCode signatures[],
+                         bool actif[],
+                         int nb_possibles,
+                         const char guess[CODE_LEN],
+                         int black_expected,
+                         int white_expected,
+                         CompteursSolveur *cpt);
+// Garde les actifs compatibles avec toutes les contraintes (proposition,
+// case noirs*5+blancs attendue), en une passe ; au plus 256 contraintes
+int filtrer_contraintes(const SignatureCode signatures[],
+                        bool actif[],
+                        int nb_possibles,
+                        const SignatureCode propositions[],
+                        const uint8_t cases[],
+                        int nb_contraintes,
+                        CompteursSolveur *cpt);
+// Histogramme des cases de chaque proposition active contre les actifs ;
+// renvoient le nombre de feedbacks calculés
+uint64_t histogrammes_direct(const SignatureCode signatures[], const bool actif[],
+                             int nb_possibles, uint16_t hist[][25]);
+uint64_t histogrammes_tuiles(const SignatureCode signatures[], const bool actif[],
+                             int nb_possibles, uint16_t hist[][25]);
+
+#endif
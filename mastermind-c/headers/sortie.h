@@ -0,0 +1,38 @@
+#ifndef SORTIE_H
+#define SORTIE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/* Sortie console tamponnée : une partie formate ses lignes dans son propre
+   tampon, vidé en une écriture par tour (avant chaque saisie). En mode muet
+   rien n'est écrit ; compilé avec -DSORTIE_MUETTE (chemins de mesure), le
+   formatage lui-même disparaît. */
+
+#define SORTIE_TAMPON 8192
+
+typedef struct {
+    FILE *f;
+    bool muet;
+    size_t n;
+    char buf[SORTIE_TAMPON];
+} Sortie;
+
+// Mode muet global (option --quiet), repris par chaque sortie_init
+void sortie_rendre_muette(bool muet);
+void sortie_init(Sortie *o, FILE *f);
+void sortie_vider(Sortie *o);
+
+void sortie_printf(Sortie *o, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+void sortie_palette(Sortie *o, int color_count);
+
+#ifdef SORTIE_MUETTE
+// Les arguments restent évalués (pas d'avertissement), le formatage disparaît
+static inline void sortie_rien(Sortie *o, ...) { (void)o; }
+#define sortie_printf(o, ...)     sortie_rien((o), __VA_ARGS__)
+#define sortie_palette(o, nb)     ((void)(o), (void)(nb))
+#endif
+
+#endif
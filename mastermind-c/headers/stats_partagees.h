@@ -0,0 +1,42 @@
+#ifndef STATS_PARTAGEES_H
+#define STATS_PARTAGEES_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "types.h"
+
+#define STATS_SEG_MAGIC   0x4D4D5354u   // "MMST"
+#define STATS_SEG_VERSION 2u
+
+// Segment de mémoire partagée entre tous les processus qui utilisent le
+// même fichier de statistiques. Disposition fixe : toute modification
+// des champs impose d'incrémenter STATS_SEG_VERSION.
+// Création, attache et détachement se font sous un verrou exclusif sur
+// <fichier>.verrou ; chaque processus attaché tient un verrou partagé sur
+// le segment lui-même, que le noyau rend s'il meurt. Le dernier détaché
+// se reconnaît donc sans compteur qu'un crash laisserait faux.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t taille;              // sizeof(SegmentStats)
+    atomic_uint pret;             // 1 une fois initialisé par le créateur
+    _Alignas(64) atomic_ulong games_played;
+    atomic_ulong games_won;
+    atomic_ulong total_tries;
+    atomic_ullong total_time_ns;
+} SegmentStats;
+
+typedef struct {
+    SegmentStats *seg;
+    int fd;                       // porte le verrou de présence
+    char nom[64];                 // nom shm_open dérivé du chemin
+    const char *chemin;
+} StatsPartagees;
+
+bool stats_partagees_ouvrir(StatsPartagees *sp, const char *chemin);
+void stats_partagees_ajouter(StatsPartagees *sp, const Stats *delta);
+void stats_partagees_lire(const StatsPartagees *sp, Stats *out);
+bool stats_partagees_fermer(StatsPartagees *sp);
+
+#endif
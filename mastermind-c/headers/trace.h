@@ -0,0 +1,24 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Trace d'exécution pour profiler le solveur sans outil externe.
+   Un fichier se terminant par ".json" reçoit des événements au format
+   Chrome (chrome://tracing, Perfetto) ; tout autre nom reçoit une ligne
+   JSON par événement. */
+
+typedef struct {
+    const char *cle;
+    long long valeur;
+} TraceArg;
+
+bool trace_ouvrir(const char *chemin);
+bool trace_active(void);
+// Un événement de durée (horodatages de horloge_ns), avec ses arguments
+void trace_evenement(const char *nom, uint64_t debut_ns, uint64_t duree_ns,
+                     const TraceArg *args, int nb_args);
+void trace_fermer(void);
+
+#endif
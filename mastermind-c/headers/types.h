@@ -2,6 +2,7 @@
 #define TYPES_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #define CODE_LEN 4
 #define MAX_COLORS 6
@@ -21,6 +22,8 @@ typedef struct {
     char guesses[64][CODE_LEN];
     int blacks[64];
     int whites[64];
+    uint64_t durees_ns[64];    // temps de chaque tentative (horloge monotone)
+    uint64_t duree_ns;         // temps total de la partie
     int tries;
     char secret[CODE_LEN];
     GameConfig cfg;
@@ -4,6 +4,17 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+typedef enum {
+    LECTURE_OK,
+    LECTURE_DELAI,      // attente écoulée avant la fin de la ligne
+    LECTURE_FIN         // fin de l'entrée ou erreur
+} ResultatLecture;
+
 bool lire_ligne(char *buffer, size_t buflen);
+// Attend au plus attente_ms (-1 : sans limite) ; sur LECTURE_DELAI, ce qui
+// a déjà été tapé reste dans le tampon
+ResultatLecture lire_ligne_attente(char *buffer, size_t buflen, int attente_ms);
+// Écarte la ligne en cours de saisie (tentative abandonnée à l'échéance)
+void abandonner_ligne(void);
 
 #endif